@@ -0,0 +1,27 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+// Runs `body` `repeat` times and prints the best wall time per processed element.
+// The best-of-N figure filters out page faults and frequency ramp-up on the first pass.
+template <typename Body>
+inline double measure(const char* name, size_t elements, Body body, int repeat = 5) {
+    double best = 0;
+    for (int i = 0; i < repeat; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto finish = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(finish - start).count() / elements;
+        if (i == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    std::printf("%-48s %10.3f ns/element\n", name, best);
+    return best;
+}
+
+// Keeps the optimizer from discarding a computed value.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
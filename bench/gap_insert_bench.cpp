@@ -0,0 +1,51 @@
+#include <cstdlib>
+#include <iterator>
+
+#include "bench.h"
+#include "unrolled_list.h"
+
+/*
+    Editor-like workload: a cursor is placed somewhere in the list and a run of
+    elements is typed in front of it, each insert right after the previous one. Plain
+    inserts move the rest of the node every time; through an insert_cursor the node's
+    tail is moved once per node and the inserts fill the free slots.
+    Usage: gap-insert-bench [elements] [run length]
+*/
+
+template <size_t NodeMaxSize>
+void run(const char* plain_name, const char* gap_name, size_t elements, size_t length) {
+    for (bool gap : {false, true}) {
+        measure(gap ? gap_name : plain_name, elements, [&] {
+            unrolled_list<size_t, NodeMaxSize> list;
+            for (size_t i = 0; i < 1024; ++i) {
+                list.push_back(i);
+            }
+            size_t inserted = 0;
+            while (inserted < elements) {
+                // cursor jumps within the first 1024 elements so the walk stays short
+                auto it = std::next(list.begin(), (inserted / length * 97) % 1024);
+                if (gap) {
+                    auto cursor = list.insert_cursor(it);
+                    for (size_t i = 0; i < length && inserted < elements; ++i, ++inserted) {
+                        cursor.insert(i);
+                    }
+                    continue;
+                }
+                for (size_t i = 0; i < length && inserted < elements; ++i, ++inserted) {
+                    it = list.insert(it, i);
+                    ++it;
+                }
+            }
+            do_not_optimize(list.back());
+        });
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t length = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+
+    run<64>("shifting inserts, node 64", "gap inserts, node 64", elements, length);
+    run<256>("shifting inserts, node 256", "gap inserts, node 256", elements, length);
+    return 0;
+}
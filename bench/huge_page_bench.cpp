@@ -0,0 +1,47 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench.h"
+#include "huge_page_allocator.h"
+#include "unrolled_list.h"
+
+/*
+    Compares push_back and full-scan throughput of unrolled_list backed by std::allocator
+    and by huge_page_allocator. Usage: huge-page-bench [elements]
+*/
+
+template <typename List>
+void run(const char* label, size_t elements, List& list) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s push_back", label);
+    measure(name, elements, [&] {
+        list.clear();
+        for (size_t i = 0; i < elements; ++i) {
+            list.push_back(i);
+        }
+    }, 1);
+    std::snprintf(name, sizeof(name), "%s iterate", label);
+    measure(name, elements, [&] {
+        size_t sum = 0;
+        for (size_t value : list) {
+            sum += value;
+        }
+        do_not_optimize(sum);
+    });
+}
+
+int main(int argc, char** argv) {
+    size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+
+    {
+        unrolled_list<size_t, 64> list;
+        run("std::allocator", elements, list);
+    }
+    {
+        huge_page_resource resource;
+        unrolled_list<size_t, 64, huge_page_allocator<size_t>> list(&resource);
+        run("huge_page_allocator", elements, list);
+        std::printf("transparent huge pages: %s\n", resource.uses_huge_pages() ? "yes" : "no");
+    }
+    return 0;
+}
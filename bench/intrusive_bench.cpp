@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "intrusive_unrolled_list.h"
+
+/*
+    Large objects scattered over memory: building a list that copies them versus linking
+    them into an intrusive_unrolled_list, then scanning them through a plain pointer list
+    and through the intrusive iterator, which prefetches the pointees ahead.
+    Usage: intrusive-bench [elements]
+*/
+
+struct Record {
+    size_t id;
+    char payload[248];
+};
+
+int main(int argc, char** argv) {
+    size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    std::vector<Record> owner(elements);
+    std::vector<Record*> order(elements);
+    for (size_t i = 0; i < elements; ++i) {
+        owner[i].id = i;
+        order[i] = &owner[i];
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+
+    measure("unrolled_list<Record> push_back (copies)", elements, [&] {
+        unrolled_list<Record, 16> list;
+        for (Record* obj : order) {
+            list.push_back(*obj);
+        }
+        do_not_optimize(list.back().id);
+    }, 3);
+    measure("intrusive_unrolled_list push_back", elements, [&] {
+        intrusive_unrolled_list<Record, 32> list;
+        for (Record* obj : order) {
+            list.push_back(*obj);
+        }
+        do_not_optimize(list.back().id);
+    }, 3);
+
+    unrolled_list<Record*, 32> pointers;
+    intrusive_unrolled_list<Record, 32> intrusive;
+    for (Record* obj : order) {
+        pointers.push_back(obj);
+        intrusive.push_back(*obj);
+    }
+    measure("unrolled_list<Record*> scan", elements, [&] {
+        size_t sum = 0;
+        for (Record* obj : pointers) {
+            sum += obj->id;
+        }
+        do_not_optimize(sum);
+    });
+    measure("intrusive_unrolled_list scan (prefetching)", elements, [&] {
+        size_t sum = 0;
+        for (const Record& obj : intrusive) {
+            sum += obj.id;
+        }
+        do_not_optimize(sum);
+    });
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench.h"
+#include "unrolled_list.h"
+
+/*
+    Compares full-scan throughput of unrolled_list against std::vector for several node
+    sizes, forward and backward. With large nodes the list is expected to stay within
+    1.2x of the vector. Usage: iteration-bench [elements]
+*/
+
+template <size_t NodeMaxSize>
+void run(size_t elements, double baseline) {
+    unrolled_list<size_t, NodeMaxSize> list;
+    for (size_t i = 0; i < elements; ++i) {
+        list.push_back(i);
+    }
+    char name[64];
+    std::snprintf(name, sizeof(name), "unrolled_list<%zu> iterate", NodeMaxSize);
+    double forward = measure(name, elements, [&] {
+        size_t sum = 0;
+        for (size_t value : list) {
+            sum += value;
+        }
+        do_not_optimize(sum);
+    });
+    std::snprintf(name, sizeof(name), "unrolled_list<%zu> reverse iterate", NodeMaxSize);
+    measure(name, elements, [&] {
+        size_t sum = 0;
+        for (auto it = list.rbegin(); it != list.rend(); ++it) {
+            sum += *it;
+        }
+        do_not_optimize(sum);
+    });
+    std::printf("%-48s %10.2fx\n", "  ratio to std::vector", forward / baseline);
+}
+
+int main(int argc, char** argv) {
+    size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+
+    std::vector<size_t> vector;
+    for (size_t i = 0; i < elements; ++i) {
+        vector.push_back(i);
+    }
+    double baseline = measure("std::vector iterate", elements, [&] {
+        size_t sum = 0;
+        for (size_t value : vector) {
+            sum += value;
+        }
+        do_not_optimize(sum);
+    });
+
+    run<16>(elements, baseline);
+    run<64>(elements, baseline);
+    run<256>(elements, baseline);
+    run<1024>(elements, baseline);
+    return 0;
+}
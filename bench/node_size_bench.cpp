@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+
+#include "bench.h"
+#include "dynamic_unrolled_list.h"
+
+/*
+    Runs three workloads over dynamic_unrolled_list for a range of node sizes to show which
+    size wins where: many tiny lists (build and scan), one giant list (append and scan) and
+    edits at a cursor moving through a mid-sized list. Usage: node-size-bench [scale]
+*/
+
+void tiny_lists(size_t node_size, size_t scale) {
+    size_t lists = 20000 * scale;
+    const size_t length = 6;
+    char name[64];
+    std::snprintf(name, sizeof(name), "tiny lists, node %zu", node_size);
+    measure(name, lists * length, [&] {
+        std::allocator<dynamic_unrolled_list<int>> alloc;
+        dynamic_unrolled_list<int>* all = alloc.allocate(lists);
+        size_t sum = 0;
+        for (size_t i = 0; i < lists; ++i) {
+            std::construct_at(all + i, node_size);
+            for (size_t j = 0; j < length; ++j) {
+                all[i].push_back(j);
+            }
+        }
+        for (size_t i = 0; i < lists; ++i) {
+            for (int value : all[i]) {
+                sum += value;
+            }
+            std::destroy_at(all + i);
+        }
+        alloc.deallocate(all, lists);
+        do_not_optimize(sum);
+    }, 3);
+}
+
+void giant_list(size_t node_size, size_t scale) {
+    size_t elements = 2000000 * scale;
+    char name[64];
+    std::snprintf(name, sizeof(name), "giant list, node %zu", node_size);
+    measure(name, elements, [&] {
+        dynamic_unrolled_list<int> list(node_size);
+        for (size_t i = 0; i < elements; ++i) {
+            list.push_back(i);
+        }
+        size_t sum = 0;
+        for (int value : list) {
+            sum += value;
+        }
+        do_not_optimize(sum);
+    }, 3);
+}
+
+void cursor_edits(size_t node_size, size_t scale, bool adaptive) {
+    size_t edits = 50000 * scale;
+    char name[64];
+    std::snprintf(name, sizeof(name), "cursor edits, node %zu%s", node_size,
+                  adaptive ? " adaptive" : "");
+    measure(name, edits, [&] {
+        dynamic_unrolled_list<int> list(node_size);
+        for (int i = 0; i < 20000; ++i) {
+            list.push_back(i);
+        }
+        list.set_adaptive(adaptive);
+        auto it = list.cbegin();
+        for (size_t i = 0; i < edits; ++i) {
+            if (it == list.cend()) {
+                it = list.cbegin();
+            }
+            it = list.insert(it, i);
+            std::advance(it, 3);
+            if (i % 2 && it != list.cend()) {
+                it = list.erase(it);
+            }
+        }
+        do_not_optimize(list.size());
+    }, 3);
+}
+
+int main(int argc, char** argv) {
+    size_t scale = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+    const size_t sizes[] = {4, 8, 16, 64, 256, 1024, 4096};
+    for (size_t node_size : sizes) {
+        tiny_lists(node_size, scale);
+    }
+    for (size_t node_size : sizes) {
+        giant_list(node_size, scale);
+    }
+    for (size_t node_size : sizes) {
+        cursor_edits(node_size, scale, false);
+    }
+    cursor_edits(1024, scale, true);
+    return 0;
+}
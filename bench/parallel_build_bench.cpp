@@ -0,0 +1,44 @@
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "bench.h"
+#include "unrolled_list.h"
+
+/*
+    Builds a list from a generator with push_back and with from_parallel on 1, 2, 4, ...
+    threads up to twice the hardware thread count, then transforms it with transform_to.
+    Speedup over push_back should grow almost linearly while there are idle cores.
+    Usage: parallel-build-bench [elements]
+*/
+
+int main(int argc, char** argv) {
+    size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+    auto gen = [](size_t i) { return i * 2654435761u; };
+
+    double sequential = measure("push_back", elements, [&] {
+        unrolled_list<size_t, 256> list;
+        for (size_t i = 0; i < elements; ++i) {
+            list.push_back(gen(i));
+        }
+        do_not_optimize(list.back());
+    }, 3);
+
+    size_t limit = 2 * std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= limit; threads *= 2) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "from_parallel, %zu threads", threads);
+        double parallel = measure(name, elements, [&] {
+            auto list = unrolled_list<size_t, 256>::from_parallel(elements, gen, {threads});
+            do_not_optimize(list.back());
+        }, 3);
+        std::printf("%-48s %10.2fx\n", "  speedup over push_back", sequential / parallel);
+    }
+
+    auto source = unrolled_list<size_t, 256>::from_parallel(elements, gen);
+    measure("transform_to", elements, [&] {
+        auto list = source.transform_to([](size_t value) { return value % 1000; });
+        do_not_optimize(list.back());
+    }, 3);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <cstdlib>
+#include <string>
+
+#include "bench.h"
+#include "unrolled_list.h"
+
+/*
+    push_back / push_front throughput for a type whose copy cannot throw and for one whose
+    copy may throw. The first takes the paths without try blocks; the second pays only for
+    building a node before linking it. The build prints the size of this binary after
+    linking, which is how the code size of the push paths is compared between revisions.
+    Usage: push-bench [elements]
+*/
+
+struct plain {
+    long value;
+};
+
+struct may_throw {
+    may_throw(long value) : value(value) {}
+    may_throw(const may_throw& other) noexcept(false) : value(other.value) {}
+    may_throw(may_throw&&) noexcept = default;
+    may_throw& operator=(const may_throw&) = default;
+    may_throw& operator=(may_throw&&) noexcept = default;
+
+    long value;
+};
+
+template <typename T>
+void run(const std::string& name, size_t elements) {
+    measure((name + " push_back").c_str(), elements, [&] {
+        unrolled_list<T, 64> list;
+        for (size_t i = 0; i < elements; ++i) {
+            list.push_back(T(static_cast<long>(i)));
+        }
+        do_not_optimize(list.back());
+    });
+    measure((name + " push_front").c_str(), elements, [&] {
+        unrolled_list<T, 64> list;
+        for (size_t i = 0; i < elements; ++i) {
+            list.push_front(T(static_cast<long>(i)));
+        }
+        do_not_optimize(list.front());
+    });
+}
+
+int main(int argc, char** argv) {
+    size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+
+    run<plain>("nothrow copy", elements);
+    run<may_throw>("throwing copy", elements);
+    return 0;
+}
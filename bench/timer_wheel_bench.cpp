@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <span>
+
+#include "bench.h"
+#include "timer_wheel.h"
+#include "unrolled_list.h"
+
+/*
+    Scheduler workload: `pending` timers are kept armed; every tick the expired ones fire
+    and each re-arms itself a random 1..horizon ticks ahead. The baseline keeps the timers
+    in an unrolled_list sorted by deadline, found by a linear search from the front, and
+    pops the front; timer_wheel pushes in O(1) and hands expired timers out in node chunks.
+    Usage: timer-wheel-bench [timer operations] [pending] [horizon]
+*/
+
+struct timer {
+    uint64_t deadline;
+    uint32_t id;
+};
+
+int main(int argc, char** argv) {
+    size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t pending = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    uint64_t horizon = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000;
+
+    measure("sorted unrolled_list", elements, [&] {
+        std::mt19937_64 gen(1);
+        unrolled_list<timer, 64> list;
+        auto arm = [&](uint64_t deadline, uint32_t id) {
+            auto it = list.begin();
+            while (it != list.end() && it->deadline <= deadline) {
+                ++it;
+            }
+            list.insert(it, timer{deadline, id});
+        };
+        for (size_t i = 0; i < pending; ++i) {
+            arm(1 + gen() % horizon, static_cast<uint32_t>(i));
+        }
+        size_t fired = 0;
+        for (uint64_t now = 1; fired < elements; ++now) {
+            while (!list.empty() && list.front().deadline <= now && fired < elements) {
+                uint32_t id = list.front().id;
+                list.pop_front();
+                arm(now + 1 + gen() % horizon, id);
+                ++fired;
+            }
+        }
+        do_not_optimize(list.size());
+    });
+
+    measure("timer_wheel", elements, [&] {
+        std::mt19937_64 gen(1);
+        timer_wheel<uint32_t, 64> wheel;
+        for (size_t i = 0; i < pending; ++i) {
+            wheel.push(1 + gen() % horizon, static_cast<uint32_t>(i));
+        }
+        size_t fired = 0;
+        for (uint64_t now = 1; fired < elements; ++now) {
+            fired += wheel.pop_expired(now, [&](std::span<timer_entry<uint32_t>> chunk) {
+                for (timer_entry<uint32_t>& item : chunk) {
+                    wheel.push(now + 1 + gen() % horizon, item.value);
+                }
+            });
+        }
+        do_not_optimize(wheel.size());
+    });
+    return 0;
+}
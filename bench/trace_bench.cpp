@@ -0,0 +1,59 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <type_traits>
+
+#include "bench.h"
+#include "unrolled_list.h"
+
+/*
+    Runs the same push/pop/insert workload on an unrolled_list with the default policy
+    and with latency_histograms, then prints the recorded histograms. The default scope
+    is an empty, trivially destructible literal type, so the uninstrumented list should
+    time the same as before the policy existed; the instrumented one shows the cost of
+    two timestamps and one bucket store per operation.
+    Usage: trace-bench [elements] [json]
+*/
+
+static_assert(std::is_empty_v<no_instrumentation::scope>);
+static_assert(std::is_trivially_destructible_v<no_instrumentation::scope>);
+static_assert(sizeof(unrolled_list<size_t, 64>) ==
+              sizeof(unrolled_list<size_t, 64, std::allocator<size_t>, latency_histograms>));
+
+template <typename Instrumentation>
+double run(const char* name, size_t elements) {
+    return measure(name, elements, [&] {
+        unrolled_list<size_t, 64, std::allocator<size_t>, Instrumentation> list;
+        for (size_t i = 0; i < elements; ++i) {
+            list.push_back(i);
+        }
+        for (size_t i = 0; i < elements / 64; ++i) {
+            list.insert(list.cbegin(), i);
+        }
+        size_t sum = 0;
+        while (!list.empty()) {
+            sum += list.front();
+            list.pop_front();
+        }
+        do_not_optimize(sum);
+    });
+}
+
+int main(int argc, char** argv) {
+    size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    bool json = argc > 2;
+
+    double plain = run<no_instrumentation>("no_instrumentation", elements);
+    latency_histograms::reset();
+    double traced = run<latency_histograms>("latency_histograms", elements);
+    std::printf("%-48s %10.2fx\n", "  instrumented / plain", traced / plain);
+
+    latency_snapshot snapshot = latency_histograms::snapshot();
+    if (json) {
+        snapshot.write_json(std::cout);
+        std::cout << '\n';
+    } else {
+        snapshot.write_text(std::cout);
+    }
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "unrolled_list.h"
+
+/*
+    Differential fuzzing: every input is decoded into a sequence of operations that is
+    applied both to an unrolled_list and to a std::deque. After each step the list must
+    report no broken invariant (see unrolled_list::broken_invariant) and, unless a run of
+    inserts through an insert_cursor is open, hold the same elements as the deque. The
+    first input byte picks the element type and NodeMaxSize.
+
+    Built as a libFuzzer target with -DUNROLLED_LIST_LIBFUZZER=ON (clang only). Otherwise
+    it is a standalone program that ctest runs on random inputs:
+        differential-fuzz [inputs] [seed]   random inputs
+        differential-fuzz file...           replay saved inputs
+*/
+
+namespace {
+
+// Reads operation codes and arguments off the input; past its end everything is zero.
+class input {
+   public:
+    input(const uint8_t* data, size_t size) : data(data), size(size), pos(0) {}
+
+    bool done() const { return pos >= size; }
+    uint8_t byte() { return pos < size ? data[pos++] : 0; }
+    size_t number(size_t bound) {
+        size_t res = byte();
+        res = (res << 8) | byte();
+        return bound == 0 ? 0 : res % bound;
+    }
+
+   private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+};
+
+template <typename T>
+T make_value(size_t seed);
+template <>
+int make_value<int>(size_t seed) {
+    return static_cast<int>(seed);
+}
+// long enough to live on the heap, so a lost or doubled destructor shows up under ASAN
+template <>
+std::string make_value<std::string>(size_t seed) {
+    return "value that does not fit into sso #" + std::to_string(seed);
+}
+
+[[noreturn]] void fail(const char* what, size_t step) {
+    std::fprintf(stderr, "differential-fuzz: %s at step %zu\n", what, step);
+    std::abort();
+}
+
+template <typename T, size_t NodeMaxSize>
+void run(input& in) {
+    unrolled_list<T, NodeMaxSize> list;
+    std::deque<T> model;
+    std::optional<typename unrolled_list<T, NodeMaxSize>::gap_cursor> cursor;
+    size_t cursor_pos = 0;
+
+    for (size_t step = 0; !in.done(); ++step) {
+        T value = make_value<T>(step);
+        uint8_t op = in.byte() % 17;
+        if (op != 9 && op != 10 && op != 14) {
+            // anything but the run itself ends it, and the cursor closes its gap
+            cursor.reset();
+        }
+        switch (op) {
+            case 0:
+                list.push_back(value);
+                model.push_back(value);
+                break;
+            case 1:
+                list.push_front(value);
+                model.push_front(value);
+                break;
+            case 2:
+                list.pop_back();
+                if (!model.empty()) {
+                    model.pop_back();
+                }
+                break;
+            case 3:
+                list.pop_front();
+                if (!model.empty()) {
+                    model.pop_front();
+                }
+                break;
+            case 4: {
+                size_t count = in.number(2 * NodeMaxSize + 2);
+                list.pop_front_n(count);
+                model.erase(model.begin(), model.begin() + std::min(count, model.size()));
+                break;
+            }
+            case 5: {
+                size_t count = in.number(2 * NodeMaxSize + 2);
+                list.pop_back_n(count);
+                model.erase(model.end() - std::min(count, model.size()), model.end());
+                break;
+            }
+            case 6: {
+                size_t pos = in.number(model.size() + 1);
+                auto it = list.insert(std::next(list.cbegin(), pos), value);
+                model.insert(model.begin() + pos, value);
+                if (*it != model[pos]) {
+                    fail("insert returned a wrong iterator", step);
+                }
+                if (pos + 1 < model.size() && *std::next(it) != model[pos + 1]) {
+                    fail("stepping from the inserted element goes wrong", step);
+                }
+                break;
+            }
+            case 7:
+                if (!model.empty()) {
+                    size_t pos = in.number(model.size());
+                    list.erase(std::next(list.cbegin(), pos));
+                    model.erase(model.begin() + pos);
+                }
+                break;
+            case 8: {
+                size_t from = in.number(model.size() + 1);
+                size_t to = from + in.number(model.size() - from + 1);
+                auto it = list.erase(std::next(list.cbegin(), from), std::next(list.cbegin(), to));
+                model.erase(model.begin() + from, model.begin() + to);
+                if (list.index_of(it) != from) {
+                    fail("range erase returned a wrong iterator", step);
+                }
+                break;
+            }
+            case 9:
+            case 10: {
+                // a run of inserts at a cursor: the first one may open a gap, the rest fill it
+                if (!cursor) {
+                    cursor_pos = in.number(model.size() + 1);
+                    cursor.emplace(list.insert_cursor(std::next(list.cbegin(), cursor_pos)));
+                }
+                cursor->insert(value);
+                model.insert(model.begin() + cursor_pos, value);
+                ++cursor_pos;
+                break;
+            }
+            case 11: {
+                std::vector<T> values;
+                for (size_t i = in.number(3 * NodeMaxSize); i > 0; --i) {
+                    values.push_back(make_value<T>(step * 1000 + i));
+                }
+                list.append_range(values);
+                model.insert(model.end(), values.begin(), values.end());
+                break;
+            }
+            case 12:
+                list.clear(in.number(4));
+                model.clear();
+                break;
+            case 13:
+                list.defragment_step(in.number(4) + 1);
+                break;
+            case 14:
+                if (cursor) {
+                    auto it = cursor->close();
+                    cursor.reset();
+                    if (cursor_pos == model.size() ? it != list.end()
+                                                   : *it != model[cursor_pos]) {
+                        fail("closing a cursor returned a wrong iterator", step);
+                    }
+                }
+                break;
+            case 15:
+                if (in.byte() % 2) {
+                    list.set_spare_nodes(in.number(5));
+                } else {
+                    list.reserve_nodes(in.number(5));
+                }
+                break;
+            default: {
+                if (!model.empty()) {
+                    size_t pos = in.number(model.size());
+                    if (list.index_of(std::next(list.cbegin(), pos)) != pos) {
+                        fail("index_of disagrees with the walk", step);
+                    }
+                }
+                unrolled_list<T, NodeMaxSize> copy(list);
+                if (!(copy == list)) {
+                    fail("copy compares unequal", step);
+                }
+                list = std::move(copy);
+                break;
+            }
+        }
+        if (const char* broken = list.broken_invariant()) {
+            fail(broken, step);
+        }
+        if (list.size() != model.size()) {
+            fail("size differs from the model", step);
+        }
+        // the list may only be read through const observers while the run's gap is open
+        if (!cursor) {
+            const auto& view = list;
+            if (!std::equal(view.begin(), view.end(), model.begin(), model.end())) {
+                fail("contents differ from the model", step);
+            }
+            if (!model.empty() && (view.front() != model.front() || view.back() != model.back() ||
+                                   *std::prev(view.end()) != model.back())) {
+                fail("front or back differs from the model", step);
+            }
+        }
+    }
+    cursor.reset();
+    if (!std::equal(list.begin(), list.end(), model.begin(), model.end())) {
+        fail("contents differ from the model", 0);
+    }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    input in(data, size);
+    switch (in.byte() % 6) {
+        case 0:
+            run<int, 2>(in);
+            break;
+        case 1:
+            run<int, 3>(in);
+            break;
+        case 2:
+            run<int, 8>(in);
+            break;
+        case 3:
+            run<int, 64>(in);
+            break;
+        case 4:
+            run<std::string, 4>(in);
+            break;
+        default:
+            run<std::string, 16>(in);
+    }
+    return 0;
+}
+
+#ifndef UNROLLED_LIST_LIBFUZZER
+int main(int argc, char** argv) {
+    if (argc > 1 && std::ifstream(argv[1])) {
+        for (int i = 1; i < argc; ++i) {
+            std::ifstream file(argv[i], std::ios::binary);
+            std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                                      std::istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(data.data(), data.size());
+        }
+        return 0;
+    }
+    size_t inputs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    std::mt19937 gen(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1);
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < inputs; ++i) {
+        data.resize(gen() % 4096);
+        for (uint8_t& byte : data) {
+            byte = static_cast<uint8_t>(gen());
+        }
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    std::printf("differential-fuzz: %zu inputs passed\n", inputs);
+    return 0;
+}
+#endif
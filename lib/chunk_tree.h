@@ -0,0 +1,640 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "my_iterator.h"
+
+// Inner node of chunk_tree. counts[i] is the number of elements below children[i];
+// which member of the union is live depends on the level the branch sits at.
+template <typename T, size_t NodeMaxSize>
+struct chunk_tree_branch {
+    static constexpr size_t fanout = 16;
+    union child {
+        chunk_tree_branch* branch;
+        node<T, NodeMaxSize>* leaf;
+    };
+    size_t size;
+    size_t counts[fanout];
+    child children[fanout];
+};
+
+// B+-tree over the usual node<T, NodeMaxSize> arrays. Inner nodes carry subtree
+// counts, so finding, inserting or erasing the k-th element, splitting and
+// concatenating all touch O(log N) nodes. Leaves stay linked through next/prev,
+// which lets the ordinary list iterators walk the whole sequence.
+template <typename T, size_t NodeMaxSize = 10, typename Allocator = std::allocator<T>>
+class chunk_tree {
+    typedef node<T, NodeMaxSize> leaf;
+    typedef chunk_tree_branch<T, NodeMaxSize> branch;
+    typedef typename branch::child child;
+    static constexpr size_t max_levels = 64;
+
+   public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef my_iterator<T, NodeMaxSize> iterator;
+    typedef my_const_iterator<T, NodeMaxSize> const_iterator;
+    typedef Allocator allocator_type;
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<leaf> allocatorNode;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<branch> allocatorBranch;
+
+    chunk_tree();
+    chunk_tree(const Allocator&);
+    chunk_tree(const chunk_tree&) = delete;
+    chunk_tree(chunk_tree&&) noexcept;
+    ~chunk_tree();
+    chunk_tree& operator=(const chunk_tree&) = delete;
+    chunk_tree& operator=(chunk_tree&&) noexcept;
+
+    inline iterator begin() { return iterator(first, 0); }
+    inline iterator end() { return iterator(last, last ? last->end : 0); }
+    inline const_iterator begin() const { return const_iterator(first, 0); }
+    inline const_iterator end() const { return const_iterator(last, last ? last->end : 0); }
+    inline const_iterator cbegin() const { return begin(); }
+    inline const_iterator cend() const { return end(); }
+
+    inline size_t size() const { return count; }
+    inline bool empty() const { return count == 0; }
+    inline size_t depth() const { return levels; }
+    inline allocator_type get_allocator() const { return Allocator(alloc); }
+
+    T& operator[](size_t);
+    const T& operator[](size_t) const;
+    iterator nth(size_t);
+
+    void insert(size_t, const T&);
+    void erase(size_t);
+    inline void push_back(const T& value) { insert(count, value); }
+    inline void push_front(const T& value) { insert(0, value); }
+    inline void pop_back() {
+        if (count) erase(count - 1);
+    }
+    inline void pop_front() {
+        if (count) erase(0);
+    }
+    // Keeps [0, index) and returns [index, size()) as a separate tree.
+    chunk_tree split(size_t);
+    // Moves every element of the argument to the back of this tree.
+    void concat(chunk_tree&&);
+    void clear() noexcept;
+
+   private:
+    static constexpr size_t capacity_at(size_t h) { return h == 0 ? NodeMaxSize : branch::fanout; }
+    static inline size_t width(child c, size_t h) { return h == 0 ? c.leaf->end : c.branch->size; }
+    static size_t total(const branch*);
+    static void insert_slot(branch*, size_t, child, size_t);
+    static void remove_slot(branch*, size_t);
+    static void move_elements(leaf*, size_t, leaf*);
+
+    leaf* locate(size_t&) const;
+    leaf* create_leaf();
+    branch* create_branch();
+    void destroy_leaf(leaf*) noexcept;
+    void destroy_branch(branch*) noexcept;
+    void destroy_subtree(child, size_t) noexcept;
+    void unlink_leaf(leaf*) noexcept;
+    void merge_nodes(child, child, size_t) noexcept;
+    void merge_children(branch*, size_t, size_t) noexcept;
+    void fix_child(branch*, size_t, size_t) noexcept;
+    void split_child(branch*, size_t, size_t, size_t keep = NodeMaxSize / 2);
+    void split_subtree(child, size_t, size_t, child&, child&);
+    void attach(child, size_t, size_t, bool);
+    void grow_root();
+    void collapse_root() noexcept;
+    void find_ends() noexcept;
+    void swap_contents(chunk_tree&) noexcept;
+
+    child root;
+    size_t levels;
+    size_t count;
+    leaf* first;
+    leaf* last;
+    allocatorNode alloc;
+};
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+chunk_tree<T, NodeMaxSize, Allocator>::chunk_tree()
+    : levels(0), count(0), first(nullptr), last(nullptr), alloc() {
+    root.leaf = nullptr;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+chunk_tree<T, NodeMaxSize, Allocator>::chunk_tree(const Allocator& al)
+    : levels(0), count(0), first(nullptr), last(nullptr), alloc(al) {
+    root.leaf = nullptr;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+chunk_tree<T, NodeMaxSize, Allocator>::chunk_tree(chunk_tree&& other) noexcept
+    : chunk_tree(Allocator(other.alloc)) {
+    swap_contents(other);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+chunk_tree<T, NodeMaxSize, Allocator>::~chunk_tree() {
+    clear();
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+chunk_tree<T, NodeMaxSize, Allocator>& chunk_tree<T, NodeMaxSize, Allocator>::operator=(
+    chunk_tree&& other) noexcept {
+    if (this != &other) {
+        clear();
+        alloc = other.alloc;
+        swap_contents(other);
+    }
+    return *this;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::swap_contents(chunk_tree& other) noexcept {
+    std::swap(root, other.root);
+    std::swap(levels, other.levels);
+    std::swap(count, other.count);
+    std::swap(first, other.first);
+    std::swap(last, other.last);
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+size_t chunk_tree<T, NodeMaxSize, Allocator>::total(const branch* target) {
+    size_t result = 0;
+    for (size_t i = 0; i < target->size; ++i) {
+        result += target->counts[i];
+    }
+    return result;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::insert_slot(branch* target, size_t index, child value,
+                                                        size_t elements) {
+    for (size_t i = target->size; i > index; --i) {
+        target->children[i] = target->children[i - 1];
+        target->counts[i] = target->counts[i - 1];
+    }
+    target->children[index] = value;
+    target->counts[index] = elements;
+    ++target->size;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::remove_slot(branch* target, size_t index) {
+    for (size_t i = index + 1; i < target->size; ++i) {
+        target->children[i - 1] = target->children[i];
+        target->counts[i - 1] = target->counts[i];
+    }
+    --target->size;
+}
+// Appends from[index, end) to `to` and cuts `from` at index.
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::move_elements(leaf* from, size_t index, leaf* to) {
+    for (size_t i = index; i < from->end; ++i) {
+        std::construct_at(to->arr() + to->end, std::move(from->arr()[i]));
+        std::destroy_at(from->arr() + i);
+        ++to->end;
+    }
+    from->end = index;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+node<T, NodeMaxSize>* chunk_tree<T, NodeMaxSize, Allocator>::locate(size_t& index) const {
+    child temp = root;
+    for (size_t h = levels; h > 0; --h) {
+        const branch* target = temp.branch;
+        size_t i = 0;
+        while (i + 1 < target->size && index >= target->counts[i]) {
+            index -= target->counts[i];
+            ++i;
+        }
+        temp = target->children[i];
+    }
+    return temp.leaf;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+T& chunk_tree<T, NodeMaxSize, Allocator>::operator[](size_t index) {
+    leaf* target = locate(index);
+    return target->arr()[index];
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+const T& chunk_tree<T, NodeMaxSize, Allocator>::operator[](size_t index) const {
+    const leaf* target = locate(index);
+    return target->arr()[index];
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+my_iterator<T, NodeMaxSize> chunk_tree<T, NodeMaxSize, Allocator>::nth(size_t index) {
+    if (index >= count) {
+        return end();
+    }
+    leaf* target = locate(index);
+    return iterator(target, index);
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+node<T, NodeMaxSize>* chunk_tree<T, NodeMaxSize, Allocator>::create_leaf() {
+    leaf* result = alloc.allocate(1);
+    std::allocator_traits<allocatorNode>::construct(alloc, result);
+    return result;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+chunk_tree_branch<T, NodeMaxSize>* chunk_tree<T, NodeMaxSize, Allocator>::create_branch() {
+    allocatorBranch branch_alloc(alloc);
+    branch* result = branch_alloc.allocate(1);
+    result->size = 0;
+    return result;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::destroy_leaf(leaf* target) noexcept {
+    std::allocator_traits<allocatorNode>::destroy(alloc, target);
+    alloc.deallocate(target, 1);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::destroy_branch(branch* target) noexcept {
+    allocatorBranch branch_alloc(alloc);
+    branch_alloc.deallocate(target, 1);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::destroy_subtree(child target, size_t h) noexcept {
+    if (h == 0) {
+        destroy_leaf(target.leaf);
+        return;
+    }
+    for (size_t i = 0; i < target.branch->size; ++i) {
+        destroy_subtree(target.branch->children[i], h - 1);
+    }
+    destroy_branch(target.branch);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::unlink_leaf(leaf* target) noexcept {
+    if (target->prev) {
+        target->prev->next = target->next;
+    } else {
+        first = target->next;
+    }
+    if (target->next) {
+        target->next->prev = target->prev;
+    } else {
+        last = target->prev;
+    }
+}
+
+// Moves everything of `right` into `left` and frees `right`; the caller checks it fits.
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::merge_nodes(child left, child right, size_t h) noexcept {
+    if (h == 0) {
+        move_elements(right.leaf, 0, left.leaf);
+        unlink_leaf(right.leaf);
+        destroy_leaf(right.leaf);
+        return;
+    }
+    for (size_t i = 0; i < right.branch->size; ++i) {
+        insert_slot(left.branch, left.branch->size, right.branch->children[i], right.branch->counts[i]);
+    }
+    destroy_branch(right.branch);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::merge_children(branch* parent, size_t index,
+                                                           size_t h) noexcept {
+    merge_nodes(parent->children[index], parent->children[index + 1], h);
+    parent->counts[index] += parent->counts[index + 1];
+    remove_slot(parent, index + 1);
+}
+// Called after children[index] shrank: drops it when empty, otherwise merges it into
+// a neighbour when it is less than half full and the two fit in one node.
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::fix_child(branch* parent, size_t index, size_t h) noexcept {
+    child target = parent->children[index];
+    if (parent->counts[index] == 0) {
+        if (h == 0) {
+            unlink_leaf(target.leaf);
+        }
+        destroy_subtree(target, h);
+        remove_slot(parent, index);
+        return;
+    }
+    size_t used = width(target, h);
+    if (used * 2 >= capacity_at(h)) {
+        return;
+    }
+    if (index + 1 < parent->size && used + width(parent->children[index + 1], h) <= capacity_at(h)) {
+        merge_children(parent, index, h);
+    } else if (index > 0 && used + width(parent->children[index - 1], h) <= capacity_at(h)) {
+        merge_children(parent, index - 1, h);
+    }
+}
+// Splits the full children[index] in two; the parent must have a free slot. A leaf keeps
+// its first `keep` elements, a branch always keeps half of its children.
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::split_child(branch* parent, size_t index, size_t h,
+                                                        size_t keep) {
+    child bufer;
+    size_t moved;
+    if (h == 0) {
+        leaf* left = parent->children[index].leaf;
+        leaf* right = create_leaf();
+        move_elements(left, keep, right);
+        right->next = left->next;
+        if (right->next) {
+            right->next->prev = right;
+        } else {
+            last = right;
+        }
+        right->prev = left;
+        left->next = right;
+        bufer.leaf = right;
+        moved = right->end;
+    } else {
+        branch* left = parent->children[index].branch;
+        branch* right = create_branch();
+        for (size_t i = branch::fanout / 2; i < left->size; ++i) {
+            insert_slot(right, right->size, left->children[i], left->counts[i]);
+        }
+        left->size = branch::fanout / 2;
+        bufer.branch = right;
+        moved = total(right);
+    }
+    parent->counts[index] -= moved;
+    insert_slot(parent, index + 1, bufer, moved);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::grow_root() {
+    branch* fresh = create_branch();
+    insert_slot(fresh, 0, root, count);
+    root.branch = fresh;
+    ++levels;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::collapse_root() noexcept {
+    if (count == 0) {
+        clear();
+        return;
+    }
+    while (levels > 0 && root.branch->size == 1) {
+        branch* old = root.branch;
+        root = old->children[0];
+        destroy_branch(old);
+        --levels;
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::find_ends() noexcept {
+    if (count == 0) {
+        first = last = nullptr;
+        return;
+    }
+    child left = root;
+    child right = root;
+    for (size_t h = levels; h > 0; --h) {
+        left = left.branch->children[0];
+        right = right.branch->children[right.branch->size - 1];
+    }
+    first = left.leaf;
+    last = right.leaf;
+    first->prev = nullptr;
+    last->next = nullptr;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::insert(size_t index, const T& value) {
+    T copy(value);
+    if (!root.leaf) {
+        root.leaf = first = last = create_leaf();
+    }
+    if (width(root, levels) == capacity_at(levels)) {
+        grow_root();
+    }
+    // full nodes are split on the way down, so every split finds room in its parent
+    // and a failed allocation leaves a valid, unchanged sequence behind
+    branch* path[max_levels];
+    size_t slots[max_levels];
+    child temp = root;
+    for (size_t h = levels; h > 0; --h) {
+        branch* target = temp.branch;
+        size_t i = 0;
+        while (i + 1 < target->size && index > target->counts[i]) {
+            index -= target->counts[i];
+            ++i;
+        }
+        if (width(target->children[i], h - 1) == capacity_at(h - 1)) {
+            // a leaf of one element can't be split with room left on both sides, so it
+            // is split at the insert position and the insert goes to whichever side is free
+            split_child(target, i, h - 1, NodeMaxSize > 1 ? NodeMaxSize / 2 : index);
+            if (index > target->counts[i] || (h == 1 && target->counts[i] == NodeMaxSize)) {
+                index -= target->counts[i];
+                ++i;
+            }
+        }
+        path[h - 1] = target;
+        slots[h - 1] = i;
+        temp = target->children[i];
+    }
+
+    leaf* target = temp.leaf;
+    T* arr = target->arr();
+    if (index == target->end) {
+        std::construct_at(arr + index, std::move(copy));
+    } else {
+        std::construct_at(arr + target->end, std::move(arr[target->end - 1]));
+        std::move_backward(arr + index, arr + target->end - 1, arr + target->end);
+        arr[index] = std::move(copy);
+    }
+    ++target->end;
+    for (size_t h = 0; h < levels; ++h) {
+        ++path[h]->counts[slots[h]];
+    }
+    ++count;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::erase(size_t index) {
+    branch* path[max_levels];
+    size_t slots[max_levels];
+    child temp = root;
+    for (size_t h = levels; h > 0; --h) {
+        branch* target = temp.branch;
+        size_t i = 0;
+        while (index >= target->counts[i]) {
+            index -= target->counts[i];
+            ++i;
+        }
+        path[h - 1] = target;
+        slots[h - 1] = i;
+        temp = target->children[i];
+    }
+
+    leaf* target = temp.leaf;
+    std::move(target->arr() + index + 1, target->arr() + target->end, target->arr() + index);
+    std::destroy_at(target->arr() + target->end - 1);
+    --target->end;
+    --count;
+    for (size_t h = 0; h < levels; ++h) {
+        --path[h]->counts[slots[h]];
+        fix_child(path[h], slots[h], h);
+    }
+    collapse_root();
+}
+
+// Cuts the subtree at 0 < index < its element count into two subtrees of the same
+// height. Only the nodes on the path to the cut are touched.
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::split_subtree(child target, size_t h, size_t index,
+                                                          child& left, child& right) {
+    if (h == 0) {
+        leaf* bufer = create_leaf();
+        move_elements(target.leaf, index, bufer);
+        bufer->next = target.leaf->next;
+        if (bufer->next) {
+            bufer->next->prev = bufer;
+        } else {
+            last = bufer;
+        }
+        bufer->prev = target.leaf;
+        target.leaf->next = bufer;
+        left = target;
+        right.leaf = bufer;
+        return;
+    }
+
+    branch* source = target.branch;
+    size_t i = 0;
+    while (index >= source->counts[i]) {
+        index -= source->counts[i];
+        ++i;
+    }
+    branch* bufer = create_branch();
+    if (index == 0) {
+        for (size_t j = i; j < source->size; ++j) {
+            insert_slot(bufer, bufer->size, source->children[j], source->counts[j]);
+        }
+        source->size = i;
+    } else {
+        child inner_left;
+        child inner_right;
+        try {
+            split_subtree(source->children[i], h - 1, index, inner_left, inner_right);
+        } catch (...) {
+            destroy_branch(bufer);
+            throw;
+        }
+        insert_slot(bufer, 0, inner_right, source->counts[i] - index);
+        for (size_t j = i + 1; j < source->size; ++j) {
+            insert_slot(bufer, bufer->size, source->children[j], source->counts[j]);
+        }
+        source->size = i + 1;
+        source->children[i] = inner_left;
+        source->counts[i] = index;
+        fix_child(source, i, h - 1);
+        fix_child(bufer, 0, h - 1);
+    }
+    left.branch = source;
+    right.branch = bufer;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+chunk_tree<T, NodeMaxSize, Allocator> chunk_tree<T, NodeMaxSize, Allocator>::split(size_t index) {
+    chunk_tree result(get_allocator());
+    if (index >= count) {
+        return result;
+    }
+    if (index == 0) {
+        swap_contents(result);
+        return result;
+    }
+    child left;
+    child right;
+    split_subtree(root, levels, index, left, right);
+    result.root = right;
+    result.levels = levels;
+    result.count = count - index;
+    root = left;
+    count = index;
+    collapse_root();
+    result.collapse_root();
+    find_ends();
+    result.find_ends();
+    return result;
+}
+
+// Hangs a subtree no taller than this tree at its back (or front), splitting full
+// nodes on the way down like insert does.
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::attach(child piece, size_t h, size_t elements,
+                                                   bool at_back) {
+    if (h == levels) {
+        if (width(root, h) + width(piece, h) <= capacity_at(h)) {
+            if (at_back) {
+                merge_nodes(root, piece, h);
+            } else {
+                merge_nodes(piece, root, h);
+                root = piece;
+            }
+            count += elements;
+            return;
+        }
+        grow_root();
+    } else if (width(root, levels) == capacity_at(levels)) {
+        grow_root();
+    }
+
+    branch* path[max_levels];
+    size_t slots[max_levels];
+    child temp = root;
+    size_t depth = 0;
+    for (size_t level = levels; level > h + 1; --level) {
+        branch* target = temp.branch;
+        size_t i = at_back ? target->size - 1 : 0;
+        if (width(target->children[i], level - 1) == capacity_at(level - 1)) {
+            split_child(target, i, level - 1);
+            i = at_back ? i + 1 : 0;
+        }
+        path[depth] = target;
+        slots[depth] = i;
+        ++depth;
+        temp = target->children[i];
+    }
+    branch* target = temp.branch;
+    size_t slot = at_back ? target->size : 0;
+    insert_slot(target, slot, piece, elements);
+    fix_child(target, slot, h);
+    for (size_t i = 0; i < depth; ++i) {
+        path[i]->counts[slots[i]] += elements;
+    }
+    count += elements;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::concat(chunk_tree&& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        swap_contents(other);
+        return;
+    }
+    leaf* seam_left = last;
+    leaf* seam_right = other.first;
+    seam_left->next = seam_right;
+    seam_right->prev = seam_left;
+    bool swapped = levels < other.levels;
+    if (swapped) {
+        swap_contents(other);
+    }
+    try {
+        attach(other.root, other.levels, other.count, !swapped);
+    } catch (...) {
+        if (swapped) {
+            swap_contents(other);
+        }
+        seam_left->next = nullptr;
+        seam_right->prev = nullptr;
+        throw;
+    }
+    other.root.leaf = nullptr;
+    other.levels = 0;
+    other.count = 0;
+    other.first = other.last = nullptr;
+    find_ends();
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void chunk_tree<T, NodeMaxSize, Allocator>::clear() noexcept {
+    if (root.leaf) {
+        destroy_subtree(root, levels);
+    }
+    root.leaf = nullptr;
+    levels = 0;
+    count = 0;
+    first = last = nullptr;
+}
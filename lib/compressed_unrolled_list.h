@@ -0,0 +1,500 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+// Node of compressed_unrolled_list. Elements are stored frame-of-reference encoded:
+// `base` is the smallest value of the node and every element keeps only its offset
+// from it, bit-packed with `width` bits. One spare word past the packed bits lets
+// every element be read with the same branch-free two-word window.
+template <typename UInt, size_t NodeMaxSize>
+class compressed_node {
+    static_assert(std::is_unsigned_v<UInt> && sizeof(UInt) <= sizeof(uint64_t));
+
+   public:
+    compressed_node();
+
+    UInt at(size_t) const;
+    void decode(UInt*) const;
+    void append(UInt);
+    inline bool fits(UInt value) const {
+        return end < NodeMaxSize && value >= base && uint64_t(value - base) <= mask() &&
+               words_for(end + 1, width) <= word_count;
+    }
+    inline uint64_t mask() const {
+        return width == 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << width) - 1;
+    }
+    static inline size_t words_for(size_t count, size_t bits) { return count * bits / 64 + 2; }
+
+    compressed_node* next;
+    compressed_node* prev;
+    size_t end;
+    UInt base;
+    uint32_t width;
+    size_t word_count;
+    uint64_t* words;
+};
+
+template <typename UInt, size_t NodeMaxSize>
+compressed_node<UInt, NodeMaxSize>::compressed_node() {
+    next = nullptr;
+    prev = nullptr;
+    end = 0;
+    base = 0;
+    width = 0;
+    word_count = 0;
+    words = nullptr;
+}
+template <typename UInt, size_t NodeMaxSize>
+UInt compressed_node<UInt, NodeMaxSize>::at(size_t index) const {
+    size_t bit = index * width;
+    size_t word = bit / 64;
+    size_t offset = bit % 64;
+    // (x << 1) << (63 - offset) is x << (64 - offset) without the undefined shift by 64
+    uint64_t window = (words[word] >> offset) | ((words[word + 1] << 1) << (63 - offset));
+    return UInt(base + (window & mask()));
+}
+template <typename UInt, size_t NodeMaxSize>
+void compressed_node<UInt, NodeMaxSize>::decode(UInt* out) const {
+    // byte-aligned widths decode as plain widening loads, which the compiler vectorizes
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(words);
+    switch (std::endian::native == std::endian::little ? width : ~0u) {
+        case 0:
+            for (size_t i = 0; i < end; ++i) {
+                out[i] = base;
+            }
+            return;
+        case 8:
+            for (size_t i = 0; i < end; ++i) {
+                out[i] = UInt(base + bytes[i]);
+            }
+            return;
+        case 16:
+            for (size_t i = 0; i < end; ++i) {
+                uint16_t value;
+                std::memcpy(&value, bytes + 2 * i, sizeof(value));
+                out[i] = UInt(base + value);
+            }
+            return;
+        case 32:
+            for (size_t i = 0; i < end; ++i) {
+                uint32_t value;
+                std::memcpy(&value, bytes + 4 * i, sizeof(value));
+                out[i] = UInt(base + value);
+            }
+            return;
+    }
+    uint64_t bits = mask();
+    for (size_t i = 0; i < end; ++i) {
+        size_t bit = i * width;
+        size_t word = bit / 64;
+        size_t offset = bit % 64;
+        uint64_t window = (words[word] >> offset) | ((words[word + 1] << 1) << (63 - offset));
+        out[i] = UInt(base + (window & bits));
+    }
+}
+template <typename UInt, size_t NodeMaxSize>
+void compressed_node<UInt, NodeMaxSize>::append(UInt value) {
+    uint64_t delta = uint64_t(value - base);
+    size_t bit = end * width;
+    size_t word = bit / 64;
+    size_t offset = bit % 64;
+    if (width != 0) {
+        words[word] |= delta << offset;
+        if (offset + width > 64) {
+            words[word + 1] |= delta >> (64 - offset);
+        }
+    }
+    ++end;
+}
+
+template <typename UInt, size_t NodeMaxSize>
+class compressed_iterator {
+    template <typename, size_t, typename>
+    friend class compressed_unrolled_list;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    typedef UInt value_type;
+    typedef UInt reference;
+    typedef void pointer;
+    typedef std::ptrdiff_t difference_type;
+
+    inline compressed_iterator() : ptr(nullptr), current(0) {}
+    inline compressed_iterator(const compressed_node<UInt, NodeMaxSize>* obj, size_t index)
+        : ptr(obj), current(index) {}
+
+    inline reference operator*() const { return ptr->at(current); }
+    inline bool operator==(const compressed_iterator& other) const {
+        return ptr == other.ptr && current == other.current;
+    }
+    inline bool operator!=(const compressed_iterator& other) const { return !(*this == other); }
+    inline compressed_iterator& operator++() {
+        if (current + 1 < ptr->end || !ptr->next) {
+            ++current;
+        } else {
+            ptr = ptr->next;
+            current = 0;
+        }
+        return *this;
+    }
+    inline compressed_iterator& operator--() {
+        if (current > 0 || !ptr->prev) {
+            --current;
+        } else {
+            ptr = ptr->prev;
+            current = ptr->end - 1;
+        }
+        return *this;
+    }
+    inline compressed_iterator operator++(int) {
+        compressed_iterator temp = *this;
+        ++*this;
+        return temp;
+    }
+    inline compressed_iterator operator--(int) {
+        compressed_iterator temp = *this;
+        --*this;
+        return temp;
+    }
+
+   private:
+    const compressed_node<UInt, NodeMaxSize>* ptr;
+    size_t current;
+};
+
+// Unrolled list of unsigned integers with frame-of-reference compressed nodes. Reads
+// decode lazily (a single element on dereference, a whole node in for_each_segment);
+// mutations decode the node into a scratch buffer, edit it there and re-encode.
+// Appends that fit the current frame skip the round trip and pack the new value in place.
+template <typename UInt, size_t NodeMaxSize = 128, typename Allocator = std::allocator<UInt>>
+class compressed_unrolled_list {
+   public:
+    typedef UInt value_type;
+    typedef UInt reference;
+    typedef UInt const_reference;
+    typedef std::ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef compressed_iterator<UInt, NodeMaxSize> iterator;
+    typedef compressed_iterator<UInt, NodeMaxSize> const_iterator;
+    typedef Allocator allocator_type;
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<
+        compressed_node<UInt, NodeMaxSize>>
+        allocatorNode;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<uint64_t> allocatorWord;
+
+    compressed_unrolled_list();
+    compressed_unrolled_list(const Allocator&);
+    compressed_unrolled_list(const compressed_unrolled_list&) = delete;
+    compressed_unrolled_list& operator=(const compressed_unrolled_list&) = delete;
+    ~compressed_unrolled_list();
+
+    inline const_iterator begin() const { return const_iterator(head, 0); }
+    inline const_iterator end() const { return const_iterator(tail, tail->end); }
+    inline const_iterator cbegin() const { return const_iterator(head, 0); }
+    inline const_iterator cend() const { return const_iterator(tail, tail->end); }
+
+    inline size_t size() const { return capacity; }
+    inline bool empty() const { return capacity == 0; }
+    inline allocator_type get_allocator() const { return alloc; }
+    inline UInt front() const { return head->at(0); }
+    inline UInt back() const { return tail->at(tail->end - 1); }
+    // bytes held by node headers and packed payloads
+    size_t memory_usage() const;
+
+    iterator insert(const_iterator, UInt);
+    iterator erase(const_iterator) noexcept;
+    void push_back(UInt);
+    void push_front(UInt);
+    void pop_back() noexcept;
+    void pop_front() noexcept;
+    void clear() noexcept;
+
+    // Decodes every node into a scratch buffer and hands it to `f` as a span.
+    template <typename F>
+    void for_each_segment(F&& f) const;
+
+   private:
+    compressed_node<UInt, NodeMaxSize>* create_node();
+    void destroy_node(compressed_node<UInt, NodeMaxSize>*) noexcept;
+    void unlink(compressed_node<UInt, NodeMaxSize>*) noexcept;
+    void store(compressed_node<UInt, NodeMaxSize>*, const UInt*, size_t, size_t spare = 0);
+
+    compressed_node<UInt, NodeMaxSize>* head;
+    compressed_node<UInt, NodeMaxSize>* tail;
+
+    allocatorNode alloc;
+    size_t capacity;
+    size_t node_capacity;
+};
+
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::compressed_unrolled_list()
+    : compressed_unrolled_list(Allocator()) {}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::compressed_unrolled_list(
+    const Allocator& al)
+    : alloc(al) {
+    capacity = 0;
+    node_capacity = 0;
+    head = create_node();
+    tail = head;
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::~compressed_unrolled_list() {
+    while (head) {
+        compressed_node<UInt, NodeMaxSize>* temp = head->next;
+        destroy_node(head);
+        head = temp;
+    }
+    tail = nullptr;
+}
+
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+compressed_node<UInt, NodeMaxSize>* compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::create_node() {
+    compressed_node<UInt, NodeMaxSize>* result = alloc.allocate(1);
+    std::allocator_traits<allocatorNode>::construct(alloc, result);
+    ++node_capacity;
+    return result;
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::destroy_node(
+    compressed_node<UInt, NodeMaxSize>* target) noexcept {
+    if (target->words) {
+        allocatorWord word_alloc(alloc);
+        word_alloc.deallocate(target->words, target->word_count);
+    }
+    std::allocator_traits<allocatorNode>::destroy(alloc, target);
+    alloc.deallocate(target, 1);
+    --node_capacity;
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::unlink(
+    compressed_node<UInt, NodeMaxSize>* target) noexcept {
+    if (target->prev) {
+        target->prev->next = target->next;
+    } else {
+        head = target->next;
+    }
+    if (target->next) {
+        target->next->prev = target->prev;
+    } else {
+        tail = target->prev;
+    }
+    destroy_node(target);
+}
+// Re-encodes `target` from `count` plain values. `spare` reserves room for that many
+// further appends at the chosen width, so a run of push_back calls re-encodes rarely.
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::store(
+    compressed_node<UInt, NodeMaxSize>* target, const UInt* values, size_t count, size_t spare) {
+    UInt low = count ? values[0] : 0;
+    UInt high = low;
+    for (size_t i = 1; i < count; ++i) {
+        low = values[i] < low ? values[i] : low;
+        high = values[i] > high ? values[i] : high;
+    }
+    uint32_t width = uint32_t(std::bit_width(uint64_t(high - low)));
+    size_t word_count = compressed_node<UInt, NodeMaxSize>::words_for(count + spare, width);
+
+    allocatorWord word_alloc(alloc);
+    uint64_t* words = word_alloc.allocate(word_count);
+    std::fill(words, words + word_count, 0);
+
+    if (target->words) {
+        word_alloc.deallocate(target->words, target->word_count);
+    }
+    target->words = words;
+    target->word_count = word_count;
+    target->base = low;
+    target->width = width;
+    target->end = 0;
+    for (size_t i = 0; i < count; ++i) {
+        target->append(values[i]);
+    }
+}
+
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+size_t compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::memory_usage() const {
+    size_t result = 0;
+    for (compressed_node<UInt, NodeMaxSize>* temp = head; temp; temp = temp->next) {
+        result += sizeof(compressed_node<UInt, NodeMaxSize>) + temp->word_count * sizeof(uint64_t);
+    }
+    return result;
+}
+
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+compressed_iterator<UInt, NodeMaxSize> compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::insert(
+    const_iterator point, UInt value) {
+    compressed_node<UInt, NodeMaxSize>* target =
+        const_cast<compressed_node<UInt, NodeMaxSize>*>(point.ptr);
+    size_t index = point.current;
+    if (index == target->end && target->fits(value)) {
+        target->append(value);
+        ++capacity;
+        return iterator(target, index);
+    }
+
+    UInt scratch[NodeMaxSize + 1];
+    target->decode(scratch);
+    for (size_t i = target->end; i > index; --i) {
+        scratch[i] = scratch[i - 1];
+    }
+    scratch[index] = value;
+    size_t count = target->end + 1;
+
+    if (count <= NodeMaxSize) {
+        store(target, scratch, count);
+        ++capacity;
+        return iterator(target, index);
+    }
+    compressed_node<UInt, NodeMaxSize>* bufer = create_node();
+    size_t half = count / 2;
+    try {
+        store(bufer, scratch + half, count - half);
+        store(target, scratch, half);
+    } catch (...) {
+        destroy_node(bufer);
+        throw;
+    }
+    bufer->next = target->next;
+    bufer->prev = target;
+    if (target->next) {
+        target->next->prev = bufer;
+    } else {
+        tail = bufer;
+    }
+    target->next = bufer;
+    ++capacity;
+    return index < half ? iterator(target, index) : iterator(bufer, index - half);
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+compressed_iterator<UInt, NodeMaxSize> compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::erase(
+    const_iterator point) noexcept {
+    compressed_node<UInt, NodeMaxSize>* target =
+        const_cast<compressed_node<UInt, NodeMaxSize>*>(point.ptr);
+    size_t index = point.current;
+    --capacity;
+    if (target->end == 1 && node_capacity > 1) {
+        compressed_node<UInt, NodeMaxSize>* following = target->next;
+        unlink(target);
+        return following ? iterator(following, 0) : end();
+    }
+    if (index + 1 == target->end) {
+        // dropping the last element only has to clear its bits
+        --target->end;
+        size_t bit = target->end * target->width;
+        for (size_t i = bit / 64; i < target->word_count; ++i) {
+            target->words[i] &= i == bit / 64 ? (uint64_t(1) << (bit % 64)) - 1 : 0;
+        }
+    } else {
+        // the remaining values still fit the old frame, so they are repacked in place
+        UInt scratch[NodeMaxSize];
+        target->decode(scratch);
+        size_t count = target->end - 1;
+        for (size_t i = index; i < count; ++i) {
+            scratch[i] = scratch[i + 1];
+        }
+        std::fill(target->words, target->words + target->word_count, 0);
+        target->end = 0;
+        for (size_t i = 0; i < count; ++i) {
+            target->append(scratch[i]);
+        }
+    }
+    if (index == target->end && target->next) {
+        return iterator(target->next, 0);
+    }
+    return iterator(target, index);
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::push_back(UInt value) {
+    if (tail->end != 0 && tail->fits(value)) {
+        tail->append(value);
+        ++capacity;
+        return;
+    }
+    if (tail->end == NodeMaxSize) {
+        // a full compressed node is kept as is; appends open a fresh one
+        compressed_node<UInt, NodeMaxSize>* bufer = create_node();
+        try {
+            store(bufer, &value, 1, NodeMaxSize - 1);
+        } catch (...) {
+            destroy_node(bufer);
+            throw;
+        }
+        tail->next = bufer;
+        bufer->prev = tail;
+        tail = bufer;
+        ++capacity;
+        return;
+    }
+    UInt scratch[NodeMaxSize];
+    tail->decode(scratch);
+    scratch[tail->end] = value;
+    store(tail, scratch, tail->end + 1, NodeMaxSize - tail->end - 1);
+    ++capacity;
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::push_front(UInt value) {
+    if (head->end == NodeMaxSize) {
+        compressed_node<UInt, NodeMaxSize>* bufer = create_node();
+        try {
+            store(bufer, &value, 1);
+        } catch (...) {
+            destroy_node(bufer);
+            throw;
+        }
+        bufer->next = head;
+        head->prev = bufer;
+        head = bufer;
+        ++capacity;
+        return;
+    }
+    insert(begin(), value);
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::pop_back() noexcept {
+    if (capacity != 0) {
+        erase(const_iterator(tail, tail->end - 1));
+    }
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::pop_front() noexcept {
+    if (capacity != 0) {
+        erase(const_iterator(head, 0));
+    }
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::clear() noexcept {
+    while (head != tail) {
+        unlink(tail);
+    }
+    if (head->words) {
+        allocatorWord word_alloc(alloc);
+        word_alloc.deallocate(head->words, head->word_count);
+    }
+    head->words = nullptr;
+    head->word_count = 0;
+    head->end = 0;
+    head->width = 0;
+    capacity = 0;
+}
+template <typename UInt, size_t NodeMaxSize, typename Allocator>
+template <typename F>
+void compressed_unrolled_list<UInt, NodeMaxSize, Allocator>::for_each_segment(F&& f) const {
+    UInt scratch[NodeMaxSize];
+    for (compressed_node<UInt, NodeMaxSize>* temp = head; temp; temp = temp->next) {
+        if (temp->end != 0) {
+            temp->decode(scratch);
+            f(std::span<const UInt>(scratch, temp->end));
+        }
+    }
+}
@@ -0,0 +1,502 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// Reference-counted node of cow_unrolled_list. A chunk is shared by every snapshot
+// that has not written to it yet.
+template <typename T, size_t NodeMaxSize>
+struct cow_chunk {
+    std::atomic<size_t> refs;
+    size_t end;
+    alignas(T) std::byte storage[NodeMaxSize * sizeof(T)];
+
+    inline T* arr() { return reinterpret_cast<T*>(storage); }
+    inline const T* arr() const { return reinterpret_cast<const T*>(storage); }
+};
+
+// Reference-counted array of chunk pointers. Copying a list shares the spine, so a
+// snapshot costs one increment; the first write to either copy clones the spine
+// (O(nodes) pointer copies) and then only the chunk it touches.
+template <typename T, size_t NodeMaxSize>
+struct cow_spine {
+    std::atomic<size_t> refs;
+    size_t size;
+    size_t reserved;
+    size_t elements;
+    cow_chunk<T, NodeMaxSize>** chunks;
+};
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+class cow_unrolled_list;
+
+template <typename T, size_t NodeMaxSize, typename Allocator, bool IsConst>
+class cow_iterator {
+    template <typename, size_t, typename>
+    friend class cow_unrolled_list;
+    typedef std::conditional_t<IsConst, const cow_unrolled_list<T, NodeMaxSize, Allocator>,
+                               cow_unrolled_list<T, NodeMaxSize, Allocator>>
+        list_type;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    typedef T value_type;
+    typedef std::conditional_t<IsConst, const T*, T*> pointer;
+    typedef std::conditional_t<IsConst, const T&, T&> reference;
+    typedef std::ptrdiff_t difference_type;
+
+    inline cow_iterator() : list(nullptr), chunk(0), current(0) {}
+    inline cow_iterator(list_type* obj, size_t chunk_index, size_t index)
+        : list(obj), chunk(chunk_index), current(index) {}
+    inline operator cow_iterator<T, NodeMaxSize, Allocator, true>() const
+        requires(!IsConst)
+    {
+        return {list, chunk, current};
+    }
+
+    // a mutable dereference unshares the chunk first, so writes never leak into snapshots
+    inline reference operator*() const { return list->element(chunk, current); }
+    inline pointer operator->() const { return &list->element(chunk, current); }
+    inline bool operator==(const cow_iterator& other) const {
+        return chunk == other.chunk && current == other.current;
+    }
+    inline bool operator!=(const cow_iterator& other) const { return !(*this == other); }
+    inline cow_iterator& operator++() {
+        if (++current == list->chunk_size(chunk) && chunk + 1 < list->chunk_count()) {
+            ++chunk;
+            current = 0;
+        }
+        return *this;
+    }
+    inline cow_iterator& operator--() {
+        if (current == 0 && chunk > 0) {
+            --chunk;
+            current = list->chunk_size(chunk);
+        }
+        --current;
+        return *this;
+    }
+    inline cow_iterator operator++(int) {
+        cow_iterator temp = *this;
+        ++*this;
+        return temp;
+    }
+    inline cow_iterator operator--(int) {
+        cow_iterator temp = *this;
+        --*this;
+        return temp;
+    }
+
+   private:
+    list_type* list;
+    size_t chunk;
+    size_t current;
+};
+
+template <typename T, size_t NodeMaxSize = 10, typename Allocator = std::allocator<T>>
+class cow_unrolled_list {
+    template <typename, size_t, typename, bool>
+    friend class cow_iterator;
+
+   public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef cow_iterator<T, NodeMaxSize, Allocator, false> iterator;
+    typedef cow_iterator<T, NodeMaxSize, Allocator, true> const_iterator;
+    typedef Allocator allocator_type;
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<cow_chunk<T, NodeMaxSize>>
+        allocatorChunk;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<cow_spine<T, NodeMaxSize>>
+        allocatorSpine;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<cow_chunk<T, NodeMaxSize>*>
+        allocatorPointer;
+
+    cow_unrolled_list();
+    cow_unrolled_list(const Allocator&);
+    // Copies share the nodes when the allocators compare equal and copy the elements
+    // otherwise, since a node is freed by whichever list drops it last.
+    cow_unrolled_list(const cow_unrolled_list&);
+    cow_unrolled_list(const cow_unrolled_list&, const Allocator&);
+    cow_unrolled_list(cow_unrolled_list&&) noexcept;
+    ~cow_unrolled_list();
+
+    cow_unrolled_list& operator=(const cow_unrolled_list&);
+    cow_unrolled_list& operator=(cow_unrolled_list&&) noexcept(
+        std::allocator_traits<allocatorChunk>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<allocatorChunk>::is_always_equal::value);
+
+    // O(1): keeps this list's allocator and shares every node until one side writes. A
+    // plain copy does the same unless select_on_container_copy_construction picks another
+    // allocator, as polymorphic_allocator does.
+    inline cow_unrolled_list snapshot() const { return cow_unrolled_list(*this, Allocator(alloc)); }
+
+    inline iterator begin() { return iterator(this, 0, 0); }
+    inline iterator end() { return iterator(this, last_chunk(), end_index()); }
+    inline const_iterator begin() const { return const_iterator(this, 0, 0); }
+    inline const_iterator end() const { return const_iterator(this, last_chunk(), end_index()); }
+    inline const_iterator cbegin() const { return begin(); }
+    inline const_iterator cend() const { return end(); }
+
+    inline size_t size() const { return spine ? spine->elements : 0; }
+    inline bool empty() const { return size() == 0; }
+    inline allocator_type get_allocator() const { return alloc; }
+    inline const T& front() const { return spine->chunks[0]->arr()[0]; }
+    inline const T& back() const { return *std::prev(end()); }
+    inline T& front() { return element(0, 0); }
+    inline T& back() { return *std::prev(end()); }
+    // true when both lists still share the node that holds their `index`-th node slot
+    inline bool shares_node(const cow_unrolled_list& other, size_t index) const {
+        return spine && other.spine && index < spine->size && index < other.spine->size &&
+               spine->chunks[index] == other.spine->chunks[index];
+    }
+
+    iterator insert(const_iterator, const T&);
+    iterator erase(const_iterator);
+    void push_back(const T&);
+    void push_front(const T&);
+    void pop_back();
+    void pop_front();
+    void clear() noexcept;
+
+   private:
+    inline size_t chunk_count() const { return spine ? spine->size : 0; }
+    inline size_t chunk_size(size_t index) const { return spine->chunks[index]->end; }
+    inline size_t last_chunk() const { return chunk_count() ? spine->size - 1 : 0; }
+    inline size_t end_index() const { return chunk_count() ? chunk_size(spine->size - 1) : 0; }
+    inline const T& element(size_t chunk, size_t index) const {
+        return spine->chunks[chunk]->arr()[index];
+    }
+    T& element(size_t chunk, size_t index);
+
+    cow_chunk<T, NodeMaxSize>* create_chunk();
+    void release_chunk(cow_chunk<T, NodeMaxSize>*) noexcept;
+    void release_spine(cow_spine<T, NodeMaxSize>*) noexcept;
+    void unshare_spine(size_t extra = 0);
+    cow_chunk<T, NodeMaxSize>* unshare_chunk(size_t);
+    void insert_chunk(size_t, cow_chunk<T, NodeMaxSize>*);
+    void remove_chunk(size_t) noexcept;
+
+    cow_spine<T, NodeMaxSize>* spine;
+    allocatorChunk alloc;
+};
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_unrolled_list<T, NodeMaxSize, Allocator>::cow_unrolled_list() : spine(nullptr), alloc() {}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_unrolled_list<T, NodeMaxSize, Allocator>::cow_unrolled_list(const Allocator& al)
+    : spine(nullptr), alloc(al) {}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_unrolled_list<T, NodeMaxSize, Allocator>::cow_unrolled_list(const cow_unrolled_list& other)
+    : cow_unrolled_list(other, Allocator(std::allocator_traits<allocatorChunk>::
+                                             select_on_container_copy_construction(other.alloc))) {}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_unrolled_list<T, NodeMaxSize, Allocator>::cow_unrolled_list(const cow_unrolled_list& other,
+                                                                const Allocator& al)
+    : spine(nullptr), alloc(al) {
+    if (alloc == other.alloc) {
+        spine = other.spine;
+        if (spine) {
+            spine->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    try {
+        for (const T& value : other) {
+            push_back(value);
+        }
+    } catch (...) {
+        release_spine(spine);
+        throw;
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_unrolled_list<T, NodeMaxSize, Allocator>::cow_unrolled_list(cow_unrolled_list&& other) noexcept
+    : spine(other.spine), alloc(other.alloc) {
+    other.spine = nullptr;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_unrolled_list<T, NodeMaxSize, Allocator>::~cow_unrolled_list() {
+    release_spine(spine);
+    spine = nullptr;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_unrolled_list<T, NodeMaxSize, Allocator>& cow_unrolled_list<T, NodeMaxSize, Allocator>::operator=(
+    const cow_unrolled_list& other) {
+    if (this == &other) {
+        return *this;
+    }
+    if constexpr (std::allocator_traits<allocatorChunk>::propagate_on_container_copy_assignment::value) {
+        cow_unrolled_list temp(other, Allocator(other.alloc));
+        std::swap(spine, temp.spine);
+        std::swap(alloc, temp.alloc);
+    } else {
+        cow_unrolled_list temp(other, Allocator(alloc));
+        std::swap(spine, temp.spine);
+    }
+    return *this;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_unrolled_list<T, NodeMaxSize, Allocator>& cow_unrolled_list<T, NodeMaxSize, Allocator>::operator=(
+    cow_unrolled_list&& other) noexcept(
+        std::allocator_traits<allocatorChunk>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<allocatorChunk>::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    if constexpr (std::allocator_traits<allocatorChunk>::propagate_on_container_move_assignment::value) {
+        release_spine(spine);
+        spine = std::exchange(other.spine, nullptr);
+        alloc = other.alloc;
+    } else if (std::allocator_traits<allocatorChunk>::is_always_equal::value ||
+               alloc == other.alloc) {
+        release_spine(spine);
+        spine = std::exchange(other.spine, nullptr);
+    } else {
+        // the nodes can't be adopted: they would be freed through the wrong allocator
+        cow_unrolled_list temp(other, Allocator(alloc));
+        std::swap(spine, temp.spine);
+        other.clear();
+    }
+    return *this;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_chunk<T, NodeMaxSize>* cow_unrolled_list<T, NodeMaxSize, Allocator>::create_chunk() {
+    cow_chunk<T, NodeMaxSize>* result = alloc.allocate(1);
+    std::construct_at(&result->refs, 1);
+    result->end = 0;
+    return result;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::release_chunk(
+    cow_chunk<T, NodeMaxSize>* chunk) noexcept {
+    if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    std::destroy(chunk->arr(), chunk->arr() + chunk->end);
+    std::destroy_at(&chunk->refs);
+    alloc.deallocate(chunk, 1);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::release_spine(
+    cow_spine<T, NodeMaxSize>* target) noexcept {
+    if (!target || target->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    for (size_t i = 0; i < target->size; ++i) {
+        release_chunk(target->chunks[i]);
+    }
+    allocatorPointer pointer_alloc(alloc);
+    pointer_alloc.deallocate(target->chunks, target->reserved);
+    allocatorSpine spine_alloc(alloc);
+    std::destroy_at(&target->refs);
+    spine_alloc.deallocate(target, 1);
+}
+// Makes the spine private to this list with room for `extra` more chunk pointers.
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::unshare_spine(size_t extra) {
+    bool shared = spine && spine->refs.load(std::memory_order_acquire) != 1;
+    if (spine && !shared && spine->size + extra <= spine->reserved) {
+        return;
+    }
+    size_t size = chunk_count();
+    size_t reserved = std::max<size_t>(4, size + extra);
+    if (!shared && spine) {
+        reserved = std::max(reserved, spine->reserved * 2);
+    }
+
+    allocatorPointer pointer_alloc(alloc);
+    allocatorSpine spine_alloc(alloc);
+    cow_chunk<T, NodeMaxSize>** chunks = pointer_alloc.allocate(reserved);
+    cow_spine<T, NodeMaxSize>* fresh;
+    try {
+        fresh = spine_alloc.allocate(1);
+    } catch (...) {
+        pointer_alloc.deallocate(chunks, reserved);
+        throw;
+    }
+    std::construct_at(&fresh->refs, 1);
+    fresh->size = size;
+    fresh->reserved = reserved;
+    fresh->elements = size ? spine->elements : 0;
+    fresh->chunks = chunks;
+    for (size_t i = 0; i < size; ++i) {
+        chunks[i] = spine->chunks[i];
+        if (shared) {
+            chunks[i]->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (shared) {
+        release_spine(spine);
+    } else if (spine) {
+        pointer_alloc.deallocate(spine->chunks, spine->reserved);
+        std::destroy_at(&spine->refs);
+        spine_alloc.deallocate(spine, 1);
+    }
+    spine = fresh;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_chunk<T, NodeMaxSize>* cow_unrolled_list<T, NodeMaxSize, Allocator>::unshare_chunk(size_t index) {
+    unshare_spine();
+    cow_chunk<T, NodeMaxSize>* chunk = spine->chunks[index];
+    if (chunk->refs.load(std::memory_order_acquire) == 1) {
+        return chunk;
+    }
+    cow_chunk<T, NodeMaxSize>* copy = create_chunk();
+    try {
+        for (; copy->end < chunk->end; ++copy->end) {
+            std::construct_at(copy->arr() + copy->end, chunk->arr()[copy->end]);
+        }
+    } catch (...) {
+        release_chunk(copy);
+        throw;
+    }
+    spine->chunks[index] = copy;
+    release_chunk(chunk);
+    return copy;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+T& cow_unrolled_list<T, NodeMaxSize, Allocator>::element(size_t chunk, size_t index) {
+    return unshare_chunk(chunk)->arr()[index];
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::insert_chunk(size_t index,
+                                                                cow_chunk<T, NodeMaxSize>* chunk) {
+    try {
+        unshare_spine(1);
+    } catch (...) {
+        release_chunk(chunk);
+        throw;
+    }
+    std::move_backward(spine->chunks + index, spine->chunks + spine->size,
+                       spine->chunks + spine->size + 1);
+    spine->chunks[index] = chunk;
+    ++spine->size;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::remove_chunk(size_t index) noexcept {
+    release_chunk(spine->chunks[index]);
+    std::move(spine->chunks + index + 1, spine->chunks + spine->size, spine->chunks + index);
+    --spine->size;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_iterator<T, NodeMaxSize, Allocator, false> cow_unrolled_list<T, NodeMaxSize, Allocator>::insert(
+    const_iterator point, const T& value) {
+    size_t index = point.chunk;
+    size_t current = point.current;
+    if (chunk_count() == 0) {
+        push_back(value);
+        return begin();
+    }
+    cow_chunk<T, NodeMaxSize>* target = unshare_chunk(index);
+    if (target->end == NodeMaxSize) {
+        cow_chunk<T, NodeMaxSize>* bufer = create_chunk();
+        insert_chunk(index + 1, bufer);
+        size_t half = NodeMaxSize / 2;
+        for (size_t i = half; i < NodeMaxSize; ++i) {
+            std::construct_at(bufer->arr() + bufer->end, std::move(target->arr()[i]));
+            std::destroy_at(target->arr() + i);
+            ++bufer->end;
+        }
+        target->end = half;
+        if (current > half) {
+            target = bufer;
+            current -= half;
+            ++index;
+        }
+    }
+    T* arr = target->arr();
+    if (current == target->end) {
+        std::construct_at(arr + current, value);
+    } else {
+        T copy(value);
+        std::construct_at(arr + target->end, std::move(arr[target->end - 1]));
+        std::move_backward(arr + current, arr + target->end - 1, arr + target->end);
+        arr[current] = std::move(copy);
+    }
+    ++target->end;
+    ++spine->elements;
+    return iterator(this, index, current);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+cow_iterator<T, NodeMaxSize, Allocator, false> cow_unrolled_list<T, NodeMaxSize, Allocator>::erase(
+    const_iterator point) {
+    size_t index = point.chunk;
+    size_t current = point.current;
+    cow_chunk<T, NodeMaxSize>* target = unshare_chunk(index);
+    T* arr = target->arr();
+    std::move(arr + current + 1, arr + target->end, arr + current);
+    std::destroy_at(arr + target->end - 1);
+    --target->end;
+    --spine->elements;
+    if (target->end == 0) {
+        remove_chunk(index);
+        return index < spine->size ? iterator(this, index, 0) : end();
+    }
+    if (current == target->end && index + 1 < spine->size) {
+        return iterator(this, index + 1, 0);
+    }
+    return iterator(this, index, current);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::push_back(const T& value) {
+    if (chunk_count() == 0 || chunk_size(spine->size - 1) == NodeMaxSize) {
+        cow_chunk<T, NodeMaxSize>* bufer = create_chunk();
+        try {
+            std::construct_at(bufer->arr(), value);
+        } catch (...) {
+            release_chunk(bufer);
+            throw;
+        }
+        bufer->end = 1;
+        insert_chunk(chunk_count(), bufer);
+        ++spine->elements;
+        return;
+    }
+    cow_chunk<T, NodeMaxSize>* target = unshare_chunk(spine->size - 1);
+    std::construct_at(target->arr() + target->end, value);
+    ++target->end;
+    ++spine->elements;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::push_front(const T& value) {
+    if (chunk_count() == 0 || chunk_size(0) == NodeMaxSize) {
+        cow_chunk<T, NodeMaxSize>* bufer = create_chunk();
+        try {
+            std::construct_at(bufer->arr(), value);
+        } catch (...) {
+            release_chunk(bufer);
+            throw;
+        }
+        bufer->end = 1;
+        insert_chunk(0, bufer);
+        ++spine->elements;
+        return;
+    }
+    insert(begin(), value);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::pop_back() {
+    if (!empty()) {
+        erase(std::prev(cend()));
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::pop_front() {
+    if (!empty()) {
+        erase(cbegin());
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void cow_unrolled_list<T, NodeMaxSize, Allocator>::clear() noexcept {
+    release_spine(spine);
+    spine = nullptr;
+}
@@ -0,0 +1,474 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "my_iterator.h"
+
+// Node whose capacity is chosen when it is allocated. The header and the payload share
+// one block: the payload starts just past the header, so there is a single allocation per
+// node just like with the fixed-size node.
+template <typename T>
+class dynamic_node {
+    template <typename, typename>
+    friend class dynamic_unrolled_list;
+    template <typename, bool, bool>
+    friend class basic_iterator;
+
+   public:
+    typedef T value_type;
+
+    inline T& at(size_t index) { return arr()[index]; }
+    inline const T& at(size_t index) const { return arr()[index]; }
+    inline T& front() { return arr()[0]; }
+    inline T& back() { return arr()[end - 1]; }
+    inline bool full() const { return end == capacity; }
+    void link_forward(dynamic_node*);
+    void thread_forward(dynamic_node*);
+
+    dynamic_node* next;
+    dynamic_node* prev;
+    size_t end;
+    size_t capacity;
+    // never numbered: iterators order dynamic nodes by walking the chain
+    size_t ordinal = 0;
+    size_t stamp = 0;
+
+   private:
+    static constexpr size_t payload_offset() {
+        return (sizeof(dynamic_node) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+    inline T* arr() {
+        return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(this) + payload_offset());
+    }
+    inline const T* arr() const {
+        return reinterpret_cast<const T*>(reinterpret_cast<const std::byte*>(this) +
+                                          payload_offset());
+    }
+};
+
+template <typename T>
+void dynamic_node<T>::link_forward(dynamic_node* other) {
+    next = other;
+    if (other) {
+        other->prev = this;
+    }
+}
+// Moves the upper half into `bufer` and links it right after this node.
+template <typename T>
+void dynamic_node<T>::thread_forward(dynamic_node* bufer) {
+    size_t keep = end / 2;
+    for (size_t i = keep; i < end; ++i) {
+        std::construct_at(bufer->arr() + bufer->end, std::move(arr()[i]));
+        std::destroy_at(arr() + i);
+        ++bufer->end;
+    }
+    end = keep;
+    bufer->link_forward(next);
+    link_forward(bufer);
+}
+
+// Unrolled list with the node capacity picked at run time instead of by a template
+// argument, so one build can serve many tiny lists and a few huge ones. set_node_size
+// applies to the nodes created afterwards; a node more than twice the current size is
+// re-chunked the next time something is inserted into it. In adaptive mode the list
+// watches its own operation mix and halves the size while edits in the middle dominate,
+// doubling it while appends do.
+template <typename T, typename Allocator = std::allocator<T>>
+class dynamic_unrolled_list {
+   public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef basic_iterator<dynamic_node<T>, false, false> iterator;
+    typedef basic_iterator<dynamic_node<T>, true, false> const_iterator;
+    typedef basic_iterator<dynamic_node<T>, false, true> reverse_iterator;
+    typedef basic_iterator<dynamic_node<T>, true, true> const_reverse_iterator;
+    typedef Allocator allocator_type;
+
+    static constexpr size_t min_node_size = 4;
+    static constexpr size_t max_node_size = 4096;
+
+    explicit dynamic_unrolled_list(size_t node_size = 16, const Allocator& al = Allocator());
+    dynamic_unrolled_list(const dynamic_unrolled_list&);
+    dynamic_unrolled_list(dynamic_unrolled_list&&);
+    ~dynamic_unrolled_list();
+    dynamic_unrolled_list& operator=(const dynamic_unrolled_list&);
+    dynamic_unrolled_list& operator=(dynamic_unrolled_list&&);
+
+    inline iterator begin() { return iterator(head, 0); }
+    inline iterator end() { return iterator(tail, tail->end); }
+    inline const_iterator begin() const { return const_iterator(head, 0); }
+    inline const_iterator end() const { return const_iterator(tail, tail->end); }
+    inline const_iterator cbegin() const { return begin(); }
+    inline const_iterator cend() const { return end(); }
+    inline reverse_iterator rbegin() { return reverse_iterator(tail, tail->end); }
+    inline reverse_iterator rend() { return reverse_iterator(head, 0); }
+    inline const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(tail, tail->end);
+    }
+    inline const_reverse_iterator rend() const { return const_reverse_iterator(head, 0); }
+
+    inline size_t size() const { return capacity; }
+    inline bool empty() const { return capacity == 0; }
+    inline size_t nodes() const { return node_capacity; }
+    inline allocator_type get_allocator() const { return alloc; }
+    inline T& front() { return head->front(); }
+    inline T& back() { return tail->back(); }
+    inline const T& front() const { return head->at(0); }
+    inline const T& back() const { return tail->at(tail->end - 1); }
+
+    inline size_t node_size() const { return node_limit; }
+    void set_node_size(size_t);
+    inline void set_adaptive(bool enable) {
+        adaptive = enable;
+        appends = 0;
+        edits = 0;
+    }
+
+    void push_back(const T&);
+    void push_front(const T&);
+    void pop_back() noexcept;
+    void pop_front() noexcept;
+    iterator insert(const_iterator, const T&);
+    iterator erase(const_iterator) noexcept;
+    void clear() noexcept;
+    void swap(dynamic_unrolled_list&) noexcept;
+
+   private:
+    // Allocation unit for a node block, aligned for both the header and T.
+    struct alignas(std::max(alignof(dynamic_node<T>), alignof(T))) block {
+        std::byte bytes[std::max(alignof(dynamic_node<T>), alignof(T))];
+    };
+    typedef
+        typename std::allocator_traits<Allocator>::template rebind_alloc<block> allocatorBlock;
+
+    static constexpr size_t payload_offset = dynamic_node<T>::payload_offset();
+    static inline size_t blocks_for(size_t node_size) {
+        return (payload_offset + node_size * sizeof(T) + sizeof(block) - 1) / sizeof(block);
+    }
+
+    dynamic_node<T>* create_node(size_t);
+    void destroy_node(dynamic_node<T>*) noexcept;
+    void unlink_node(dynamic_node<T>*) noexcept;
+    iterator insert_at(dynamic_node<T>*, size_t, const T&);
+    iterator erase_at(dynamic_node<T>*, size_t) noexcept;
+    dynamic_node<T>* reshape(dynamic_node<T>*, size_t&);
+    inline void count(size_t& counter) {
+        ++counter;
+        if (adaptive && appends + edits >= adapt_window) {
+            adapt();
+        }
+    }
+    void adapt();
+
+    dynamic_node<T>* head;
+    dynamic_node<T>* tail;
+    allocatorBlock alloc;
+    size_t capacity;
+    size_t node_capacity;
+    size_t node_limit;
+
+    bool adaptive = false;
+    size_t appends = 0;
+    size_t edits = 0;
+    static constexpr size_t adapt_window = 1024;
+};
+
+template <typename T, typename Allocator>
+dynamic_unrolled_list<T, Allocator>::dynamic_unrolled_list(size_t node_size, const Allocator& al)
+    : alloc(al), capacity(0), node_capacity(1) {
+    node_limit = std::clamp(node_size, min_node_size, max_node_size);
+    head = create_node(node_limit);
+    tail = head;
+}
+template <typename T, typename Allocator>
+dynamic_unrolled_list<T, Allocator>::dynamic_unrolled_list(const dynamic_unrolled_list& other)
+    : dynamic_unrolled_list(other.node_limit, other.alloc) {
+    // the delegated constructor has finished, so a throwing copy is cleaned up by ~list
+    adaptive = other.adaptive;
+    for (const T& value : other) {
+        push_back(value);
+    }
+}
+template <typename T, typename Allocator>
+dynamic_unrolled_list<T, Allocator>::dynamic_unrolled_list(dynamic_unrolled_list&& other)
+    : dynamic_unrolled_list(other.node_limit, other.alloc) {
+    swap(other);
+}
+template <typename T, typename Allocator>
+dynamic_unrolled_list<T, Allocator>::~dynamic_unrolled_list() {
+    clear();
+    destroy_node(head);
+}
+template <typename T, typename Allocator>
+dynamic_unrolled_list<T, Allocator>& dynamic_unrolled_list<T, Allocator>::operator=(
+    const dynamic_unrolled_list& other) {
+    if (this != &other) {
+        dynamic_unrolled_list temp(other);
+        swap(temp);
+    }
+    return *this;
+}
+template <typename T, typename Allocator>
+dynamic_unrolled_list<T, Allocator>& dynamic_unrolled_list<T, Allocator>::operator=(
+    dynamic_unrolled_list&& other) {
+    swap(other);
+    return *this;
+}
+
+template <typename T, typename Allocator>
+dynamic_node<T>* dynamic_unrolled_list<T, Allocator>::create_node(size_t node_size) {
+    block* raw = alloc.allocate(blocks_for(node_size));
+    dynamic_node<T>* result = ::new (static_cast<void*>(raw)) dynamic_node<T>;
+    result->next = nullptr;
+    result->prev = nullptr;
+    result->end = 0;
+    result->capacity = node_size;
+    return result;
+}
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::destroy_node(dynamic_node<T>* target) noexcept {
+    std::destroy(target->arr(), target->arr() + target->end);
+    size_t blocks = blocks_for(target->capacity);
+    std::destroy_at(target);
+    alloc.deallocate(reinterpret_cast<block*>(target), blocks);
+}
+// Unlinks a node that is not the only one and frees it.
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::unlink_node(dynamic_node<T>* target) noexcept {
+    if (target->prev) {
+        target->prev->next = target->next;
+    } else {
+        head = target->next;
+    }
+    if (target->next) {
+        target->next->prev = target->prev;
+    } else {
+        tail = target->prev;
+    }
+    --node_capacity;
+    destroy_node(target);
+}
+// Runs once per window of counted operations. An edit in the middle shifts up to a node's
+// worth of elements, while appends and scans only profit from longer runs.
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::adapt() {
+    if (edits * 8 > appends + edits) {
+        node_limit = std::max(node_limit / 2, min_node_size);
+    } else if (edits * 64 < appends + edits) {
+        node_limit = std::min(node_limit * 2, max_node_size);
+    }
+    appends = 0;
+    edits = 0;
+}
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::set_node_size(size_t node_size) {
+    node_limit = std::clamp(node_size, min_node_size, max_node_size);
+}
+
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::push_back(const T& value) {
+    count(appends);
+    if (tail->full()) {
+        dynamic_node<T>* bufer = create_node(node_limit);
+        try {
+            std::construct_at(bufer->arr(), value);
+        } catch (...) {
+            destroy_node(bufer);
+            throw;
+        }
+        bufer->end = 1;
+        tail->link_forward(bufer);
+        tail = bufer;
+        ++node_capacity;
+    } else {
+        std::construct_at(tail->arr() + tail->end, value);
+        ++tail->end;
+    }
+    ++capacity;
+}
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::push_front(const T& value) {
+    count(appends);
+    if (head->full()) {
+        dynamic_node<T>* bufer = create_node(node_limit);
+        try {
+            std::construct_at(bufer->arr(), value);
+        } catch (...) {
+            destroy_node(bufer);
+            throw;
+        }
+        bufer->end = 1;
+        bufer->link_forward(head);
+        head = bufer;
+        ++node_capacity;
+        ++capacity;
+        return;
+    }
+    insert_at(head, 0, value);
+}
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::pop_back() noexcept {
+    std::destroy_at(tail->arr() + --tail->end);
+    --capacity;
+    if (tail->end == 0 && tail != head) {
+        unlink_node(tail);
+    }
+}
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::pop_front() noexcept {
+    erase_at(head, 0);
+}
+template <typename T, typename Allocator>
+typename dynamic_unrolled_list<T, Allocator>::iterator dynamic_unrolled_list<T, Allocator>::insert(
+    const_iterator point, const T& value) {
+    count(edits);
+    return insert_at(const_cast<dynamic_node<T>*>(point.ptr), point.index(), value);
+}
+template <typename T, typename Allocator>
+typename dynamic_unrolled_list<T, Allocator>::iterator dynamic_unrolled_list<T, Allocator>::erase(
+    const_iterator point) noexcept {
+    count(edits);
+    return erase_at(const_cast<dynamic_node<T>*>(point.ptr), point.index());
+}
+template <typename T, typename Allocator>
+typename dynamic_unrolled_list<T, Allocator>::iterator
+dynamic_unrolled_list<T, Allocator>::insert_at(dynamic_node<T>* target, size_t index,
+                                               const T& value) {
+    if (target->capacity > 2 * node_limit) {
+        target = reshape(target, index);
+    }
+    if (target->full()) {
+        // the new half takes the current node size, but must also fit what moves into it
+        // plus the value being inserted
+        size_t moved = target->end - target->end / 2;
+        dynamic_node<T>* bufer = create_node(std::max(node_limit, moved + 1));
+        target->thread_forward(bufer);
+        ++node_capacity;
+        if (tail == target) {
+            tail = bufer;
+        }
+        if (index > target->end) {
+            index -= target->end;
+            target = bufer;
+        }
+    }
+    T* slot = target->arr() + index;
+    T* last = target->arr() + target->end;
+    if (slot == last) {
+        std::construct_at(last, value);
+    } else {
+        // copy first, so a throwing copy leaves the node untouched
+        T temp(value);
+        std::construct_at(last, std::move(last[-1]));
+        std::move_backward(slot, last - 1, last);
+        *slot = std::move(temp);
+    }
+    ++target->end;
+    ++capacity;
+    return iterator(target, index);
+}
+template <typename T, typename Allocator>
+typename dynamic_unrolled_list<T, Allocator>::iterator
+dynamic_unrolled_list<T, Allocator>::erase_at(dynamic_node<T>* target, size_t index) noexcept {
+    std::move(target->arr() + index + 1, target->arr() + target->end, target->arr() + index);
+    std::destroy_at(target->arr() + --target->end);
+    --capacity;
+
+    dynamic_node<T>* next = target->next;
+    if (target->end == 0 && node_capacity > 1) {
+        unlink_node(target);
+        return next ? iterator(next, 0) : end();
+    }
+    // fold the next node in while both fit, so erasing keeps the nodes dense
+    if (next && target->end + next->end <= target->capacity) {
+        for (size_t i = 0; i < next->end; ++i) {
+            std::construct_at(target->arr() + target->end + i, std::move(next->arr()[i]));
+        }
+        target->end += next->end;
+        unlink_node(next);
+    }
+    if (index < target->end || !target->next) {
+        return iterator(target, index);
+    }
+    return iterator(target->next, 0);
+}
+// Replaces an oversized node by half-full nodes of the current size. Returns the node
+// that now holds position `index` and rebases `index` into it.
+template <typename T, typename Allocator>
+dynamic_node<T>* dynamic_unrolled_list<T, Allocator>::reshape(dynamic_node<T>* target,
+                                                              size_t& index) {
+    size_t step = node_limit / 2;
+    size_t count = std::max<size_t>((target->end + step - 1) / step, 1);
+    // allocate the whole chain first, so running out of memory leaves the list as it was
+    dynamic_node<T>* first = create_node(node_limit);
+    dynamic_node<T>* last = first;
+    try {
+        for (size_t i = 1; i < count; ++i) {
+            dynamic_node<T>* bufer = create_node(node_limit);
+            last->link_forward(bufer);
+            last = bufer;
+        }
+    } catch (...) {
+        while (first) {
+            dynamic_node<T>* temp = first->next;
+            destroy_node(first);
+            first = temp;
+        }
+        throw;
+    }
+    size_t from = 0;
+    for (dynamic_node<T>* temp = first; temp; temp = temp->next) {
+        for (; temp->end < step && from < target->end; ++from) {
+            std::construct_at(temp->arr() + temp->end, std::move(target->arr()[from]));
+            ++temp->end;
+        }
+    }
+
+    if (target->prev) {
+        target->prev->link_forward(first);
+    } else {
+        head = first;
+        first->prev = nullptr;
+    }
+    if (target->next) {
+        last->link_forward(target->next);
+    } else {
+        tail = last;
+    }
+    node_capacity += count - 1;
+    destroy_node(target);
+
+    dynamic_node<T>* result = first;
+    while (index > result->end) {
+        index -= result->end;
+        result = result->next;
+    }
+    return result;
+}
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::clear() noexcept {
+    while (head != tail) {
+        unlink_node(tail);
+    }
+    std::destroy(head->arr(), head->arr() + head->end);
+    head->end = 0;
+    capacity = 0;
+}
+template <typename T, typename Allocator>
+void dynamic_unrolled_list<T, Allocator>::swap(dynamic_unrolled_list& other) noexcept {
+    std::swap(head, other.head);
+    std::swap(tail, other.tail);
+    std::swap(alloc, other.alloc);
+    std::swap(capacity, other.capacity);
+    std::swap(node_capacity, other.node_capacity);
+    std::swap(node_limit, other.node_limit);
+    std::swap(adaptive, other.adaptive);
+    std::swap(appends, other.appends);
+    std::swap(edits, other.edits);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+
+#include "unrolled_list.h"
+
+// Read-only contiguous copy of a list. Built in a constant expression it is a plain
+// literal table: the nodes used to build it are gone and nothing runs at startup.
+template <typename T, size_t Size>
+struct flat_view {
+    typedef T value_type;
+    typedef const T& const_reference;
+    typedef const T* const_iterator;
+    typedef size_t size_type;
+
+    inline constexpr const T* begin() const { return items; }
+    inline constexpr const T* end() const { return items + Size; }
+    inline constexpr const T* data() const { return items; }
+    inline constexpr const T& operator[](size_t index) const { return items[index]; }
+    static constexpr size_t size() { return Size; }
+    static constexpr bool empty() { return Size == 0; }
+
+    T items[Size == 0 ? 1 : Size];
+};
+
+// Copies the first Size elements of the list.
+template <size_t Size, typename T, size_t NodeMaxSize, typename Allocator,
+          typename Instrumentation>
+constexpr flat_view<T, Size> flatten(
+    const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list) {
+    flat_view<T, Size> result{};
+    size_t index = 0;
+    for (auto it = list.cbegin(); index < Size && it != list.cend(); ++it) {
+        result.items[index++] = *it;
+    }
+    return result;
+}
+
+// Runs Builder, a constexpr callable returning an unrolled_list, during compilation
+// and keeps only the elements:
+//     constexpr auto table = flatten<[] { unrolled_list<int> l; ...; return l; }>();
+template <auto Builder>
+consteval auto flatten() {
+    constexpr size_t size = Builder().size();
+    return flatten<size>(Builder());
+}
@@ -0,0 +1,222 @@
+#pragma once
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+// Carves blocks out of large anonymous mappings that are advised to be backed by
+// transparent huge pages. Requests are rounded up to a power of two, and a freed block goes
+// to the free list of its size class to be handed out again before the mapping grows, so a
+// list that keeps splitting and merging nodes recycles the same memory and any mix of sizes
+// is reused. A block too big to share a region gets a mapping of its own, which is unmapped
+// when the block is freed. Not synchronized, like std::pmr::unsynchronized_pool_resource.
+class huge_page_resource {
+   public:
+    static constexpr size_t huge_page_size = size_t(2) << 20;
+
+    explicit huge_page_resource(size_t region_size = 16 * huge_page_size);
+    huge_page_resource(const huge_page_resource&) = delete;
+    huge_page_resource& operator=(const huge_page_resource&) = delete;
+    ~huge_page_resource();
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    void deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept;
+
+    // false when the kernel refused MADV_HUGEPAGE and the regions use regular pages
+    inline bool uses_huge_pages() const { return huge_pages; }
+    inline size_t mapped() const { return mapped_bytes; }
+    bool owns(const void*) const;
+
+   private:
+    struct region {
+        region* next;
+        size_t size;
+    };
+    struct free_block {
+        free_block* next;
+    };
+    // class i holds blocks of 2^i bytes
+    static constexpr size_t size_classes = 64;
+
+    region* map_region(size_t);
+    // bytes after rounding up to the block size class, or 0 for a dedicated mapping
+    size_t class_size(size_t bytes, size_t alignment) const;
+
+    size_t region_size;
+    region* regions;
+    char* cursor;
+    char* limit;
+    size_t mapped_bytes;
+    bool huge_pages;
+    free_block* lists[size_classes];
+};
+
+inline huge_page_resource::huge_page_resource(size_t size)
+    : region_size((size + huge_page_size - 1) / huge_page_size * huge_page_size),
+      regions(nullptr),
+      cursor(nullptr),
+      limit(nullptr),
+      mapped_bytes(0),
+      huge_pages(true),
+      lists() {}
+
+inline huge_page_resource::~huge_page_resource() {
+    while (regions) {
+        region* temp = regions->next;
+        munmap(regions, regions->size);
+        regions = temp;
+    }
+}
+
+inline huge_page_resource::region* huge_page_resource::map_region(size_t size) {
+    // over-map by one huge page so the region can start on a huge page boundary
+    size_t length = size + huge_page_size;
+    void* raw = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (begin + huge_page_size - 1) / huge_page_size * huge_page_size;
+    if (aligned != begin) {
+        munmap(raw, aligned - begin);
+    }
+    if (aligned + size != begin + length) {
+        munmap(reinterpret_cast<void*>(aligned + size), begin + length - aligned - size);
+    }
+#ifdef MADV_HUGEPAGE
+    if (madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE) != 0) {
+        huge_pages = false;
+    }
+#else
+    huge_pages = false;
+#endif
+    region* result = reinterpret_cast<region*>(aligned);
+    result->next = regions;
+    result->size = size;
+    regions = result;
+    mapped_bytes += size;
+    return result;
+}
+
+inline size_t huge_page_resource::class_size(size_t bytes, size_t alignment) const {
+    size_t size = std::bit_ceil(std::max({bytes, alignment, sizeof(free_block)}));
+    return size + sizeof(region) + alignment > region_size ? 0 : size;
+}
+
+inline void* huge_page_resource::allocate(size_t bytes, size_t alignment) {
+    if (alignment < alignof(std::max_align_t)) {
+        alignment = alignof(std::max_align_t);
+    }
+    size_t size = class_size(bytes, alignment);
+    if (size == 0) {
+        // too big to share a region, give it a mapping of its own
+        size_t length = (bytes + sizeof(region) + alignment + huge_page_size - 1) /
+                        huge_page_size * huge_page_size;
+        char* base = reinterpret_cast<char*>(map_region(length)) + sizeof(region);
+        return reinterpret_cast<void*>(
+            (reinterpret_cast<uintptr_t>(base) + alignment - 1) / alignment * alignment);
+    }
+
+    // a block freed by a request of weaker alignment is left for the next one
+    free_block*& list = lists[std::countr_zero(size)];
+    if (list && reinterpret_cast<uintptr_t>(list) % alignment == 0) {
+        free_block* result = list;
+        list = result->next;
+        return result;
+    }
+    bytes = size;
+
+    uintptr_t position = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) / alignment * alignment;
+    if (!cursor || position + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        region* fresh = map_region(region_size);
+        cursor = reinterpret_cast<char*>(fresh) + sizeof(region);
+        limit = reinterpret_cast<char*>(fresh) + fresh->size;
+        position = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) / alignment * alignment;
+    }
+    cursor = reinterpret_cast<char*>(position + bytes);
+    return reinterpret_cast<void*>(position);
+}
+
+inline void huge_page_resource::deallocate(void* p, size_t bytes, size_t alignment) noexcept {
+    if (!p) {
+        return;
+    }
+    if (alignment < alignof(std::max_align_t)) {
+        alignment = alignof(std::max_align_t);
+    }
+    size_t size = class_size(bytes, alignment);
+    if (size == 0) {
+        // the block has a mapping of its own, which goes back to the kernel
+        uintptr_t address = reinterpret_cast<uintptr_t>(p);
+        for (region** link = &regions; *link; link = &(*link)->next) {
+            uintptr_t begin = reinterpret_cast<uintptr_t>(*link);
+            if (address >= begin && address < begin + (*link)->size) {
+                region* target = *link;
+                *link = target->next;
+                mapped_bytes -= target->size;
+                munmap(target, target->size);
+                return;
+            }
+        }
+        return;
+    }
+    free_block* block = static_cast<free_block*>(p);
+    block->next = lists[std::countr_zero(size)];
+    lists[std::countr_zero(size)] = block;
+}
+
+inline bool huge_page_resource::owns(const void* p) const {
+    uintptr_t address = reinterpret_cast<uintptr_t>(p);
+    for (region* temp = regions; temp; temp = temp->next) {
+        uintptr_t begin = reinterpret_cast<uintptr_t>(temp);
+        if (address >= begin && address < begin + temp->size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Allocator front end for huge_page_resource, meant to be passed as the Allocator
+// parameter of unrolled_list: the rebound node allocator then draws nodes from the
+// resource's regions and recycles them through its free list. There is no default
+// constructor: the resource is not synchronized, so a process-wide default would be shared
+// by lists on different threads. Each thread or owner passes a resource of its own.
+template <typename T>
+class huge_page_allocator {
+    template <typename>
+    friend class huge_page_allocator;
+
+   public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef size_t size_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+    inline huge_page_allocator(huge_page_resource* source) noexcept : resource(source) {}
+    template <typename U>
+    inline huge_page_allocator(const huge_page_allocator<U>& other) noexcept
+        : resource(other.resource) {}
+
+    inline T* allocate(size_t n) {
+        return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+    }
+    inline void deallocate(T* p, size_t n) noexcept {
+        resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+    inline huge_page_resource* get_resource() const noexcept { return resource; }
+
+    template <typename U>
+    inline bool operator==(const huge_page_allocator<U>& other) const noexcept {
+        return resource == other.resource;
+    }
+
+   private:
+    huge_page_resource* resource;
+};
@@ -0,0 +1,289 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "my_iterator.h"
+
+// Unrolled list whose nodes all live inside the object: a fixed pool of MaxNodes
+// nodes threaded into a free list through `next`. Nothing is ever allocated, so the
+// try_* operations report a missing free node by returning false and every call
+// does a bounded amount of work.
+template <typename T, size_t NodeMaxSize = 10, size_t MaxNodes = 16>
+class inplace_unrolled_list {
+   public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef my_iterator<T, NodeMaxSize> iterator;
+    typedef my_const_iterator<T, NodeMaxSize> const_iterator;
+
+    inplace_unrolled_list() noexcept;
+    inplace_unrolled_list(const inplace_unrolled_list&);
+    ~inplace_unrolled_list();
+    inplace_unrolled_list& operator=(const inplace_unrolled_list&);
+
+    inline iterator begin() { return iterator(head, 0); }
+    inline iterator end() { return iterator(tail, tail ? tail->end : 0); }
+    inline const_iterator begin() const { return const_iterator(head, 0); }
+    inline const_iterator end() const { return const_iterator(tail, tail ? tail->end : 0); }
+    inline const_iterator cbegin() const { return begin(); }
+    inline const_iterator cend() const { return end(); }
+
+    inline size_t size() const { return capacity; }
+    inline bool empty() const { return capacity == 0; }
+    static constexpr size_t max_size() { return NodeMaxSize * MaxNodes; }
+    inline size_t free_nodes() const { return MaxNodes - node_capacity; }
+    inline T& front() { return head->front(); }
+    inline T& back() { return tail->back(); }
+    inline const T& front() const { return head->at(0); }
+    inline const T& back() const { return tail->at(tail->end - 1); }
+
+    // false when the value needs a node and the pool has none left
+    bool try_push_back(const T&);
+    bool try_push_front(const T&);
+    bool try_insert(iterator, const T&);
+    iterator erase(iterator);
+    void pop_back();
+    void pop_front();
+    void clear() noexcept;
+
+   private:
+    node<T, NodeMaxSize>* take_node() noexcept;
+    void release_node(node<T, NodeMaxSize>*) noexcept;
+    void link_after(node<T, NodeMaxSize>*, node<T, NodeMaxSize>*) noexcept;
+    void insert_at(node<T, NodeMaxSize>*, size_t, const T&);
+    static void move_tail(node<T, NodeMaxSize>*, size_t, node<T, NodeMaxSize>*);
+
+    node<T, NodeMaxSize>* head;
+    node<T, NodeMaxSize>* tail;
+    node<T, NodeMaxSize>* spare;
+    size_t capacity;
+    size_t node_capacity;
+    node<T, NodeMaxSize> pool[MaxNodes];
+};
+
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::inplace_unrolled_list() noexcept
+    : head(nullptr), tail(nullptr), spare(nullptr), capacity(0), node_capacity(0) {
+    for (size_t i = MaxNodes; i > 0; --i) {
+        pool[i - 1].next = spare;
+        spare = pool + i - 1;
+    }
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::inplace_unrolled_list(
+    const inplace_unrolled_list& other)
+    : inplace_unrolled_list() {
+    // the copy is packed at least as densely as the source, so it always fits
+    for (const T& value : other) {
+        try_push_back(value);
+    }
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::~inplace_unrolled_list() {
+    clear();
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+inplace_unrolled_list<T, NodeMaxSize, MaxNodes>& inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::operator=(
+    const inplace_unrolled_list& other) {
+    if (this != &other) {
+        clear();
+        for (const T& value : other) {
+            try_push_back(value);
+        }
+    }
+    return *this;
+}
+
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+node<T, NodeMaxSize>* inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::take_node() noexcept {
+    node<T, NodeMaxSize>* result = spare;
+    spare = result->next;
+    result->next = nullptr;
+    result->prev = nullptr;
+    result->end = 0;
+    ++node_capacity;
+    return result;
+}
+// Unlinks an empty node and puts it back on the free list.
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+void inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::release_node(node<T, NodeMaxSize>* target) noexcept {
+    if (target->prev) {
+        target->prev->next = target->next;
+    } else {
+        head = target->next;
+    }
+    if (target->next) {
+        target->next->prev = target->prev;
+    } else {
+        tail = target->prev;
+    }
+    target->prev = nullptr;
+    target->next = spare;
+    spare = target;
+    --node_capacity;
+}
+// Links `fresh` right after `point`, or at the front when point is null.
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+void inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::link_after(node<T, NodeMaxSize>* point,
+                                                                 node<T, NodeMaxSize>* fresh) noexcept {
+    fresh->prev = point;
+    fresh->next = point ? point->next : head;
+    if (fresh->next) {
+        fresh->next->prev = fresh;
+    } else {
+        tail = fresh;
+    }
+    if (point) {
+        point->next = fresh;
+    } else {
+        head = fresh;
+    }
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+void inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::move_tail(node<T, NodeMaxSize>* from, size_t index,
+                                                                node<T, NodeMaxSize>* to) {
+    for (size_t i = index; i < from->end; ++i) {
+        std::construct_at(to->arr() + to->end, std::move(from->arr()[i]));
+        std::destroy_at(from->arr() + i);
+        ++to->end;
+    }
+    from->end = index;
+}
+// Inserts into a node that still has room.
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+void inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::insert_at(node<T, NodeMaxSize>* target, size_t index,
+                                                                const T& value) {
+    T* arr = target->arr();
+    if (index == target->end) {
+        std::construct_at(arr + index, value);
+    } else {
+        T temp(value);
+        std::construct_at(arr + target->end, std::move(arr[target->end - 1]));
+        std::move_backward(arr + index, arr + target->end - 1, arr + target->end);
+        arr[index] = std::move(temp);
+    }
+    ++target->end;
+    ++capacity;
+}
+
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+bool inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::try_push_back(const T& value) {
+    if (tail && tail->end < NodeMaxSize) {
+        insert_at(tail, tail->end, value);
+        return true;
+    }
+    if (!spare) {
+        return false;
+    }
+    node<T, NodeMaxSize>* bufer = take_node();
+    link_after(tail, bufer);
+    try {
+        insert_at(bufer, 0, value);
+    } catch (...) {
+        release_node(bufer);
+        throw;
+    }
+    return true;
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+bool inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::try_push_front(const T& value) {
+    if (head && head->end < NodeMaxSize) {
+        insert_at(head, 0, value);
+        return true;
+    }
+    if (!spare) {
+        return false;
+    }
+    node<T, NodeMaxSize>* bufer = take_node();
+    link_after(nullptr, bufer);
+    try {
+        insert_at(bufer, 0, value);
+    } catch (...) {
+        release_node(bufer);
+        throw;
+    }
+    return true;
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+bool inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::try_insert(iterator point, const T& value) {
+    if (!point.ptr) {
+        return try_push_back(value);
+    }
+    node<T, NodeMaxSize>* target = point.ptr;
+    size_t index = point.index();
+    if (target->end == NodeMaxSize) {
+        if (!spare) {
+            return false;
+        }
+        node<T, NodeMaxSize>* bufer = take_node();
+        if constexpr (NodeMaxSize == 1) {
+            // nothing to split: the value gets a node of its own on the proper side
+            link_after(index == 0 ? target->prev : target, bufer);
+            try {
+                insert_at(bufer, 0, value);
+            } catch (...) {
+                release_node(bufer);
+                throw;
+            }
+            return true;
+        }
+        move_tail(target, NodeMaxSize / 2, bufer);
+        link_after(target, bufer);
+        if (index > target->end) {
+            index -= target->end;
+            target = bufer;
+        }
+    }
+    insert_at(target, index, value);
+    return true;
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+my_iterator<T, NodeMaxSize> inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::erase(iterator point) {
+    node<T, NodeMaxSize>* target = point.ptr;
+    size_t index = point.index();
+    std::move(target->arr() + index + 1, target->arr() + target->end, target->arr() + index);
+    std::destroy_at(target->arr() + target->end - 1);
+    --target->end;
+    --capacity;
+
+    if (target->end == 0) {
+        node<T, NodeMaxSize>* next = target->next;
+        release_node(target);
+        return next ? iterator(next, 0) : end();
+    }
+    // fold the next node in while both fit in one, so erased space goes back to the pool
+    node<T, NodeMaxSize>* next = target->next;
+    if (next && target->end + next->end <= NodeMaxSize) {
+        move_tail(next, 0, target);
+        release_node(next);
+    }
+    if (index < target->end) {
+        return iterator(target, index);
+    }
+    return target->next ? iterator(target->next, 0) : end();
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+void inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::pop_back() {
+    if (capacity) {
+        erase(iterator(tail, tail->end - 1));
+    }
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+void inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::pop_front() {
+    if (capacity) {
+        erase(begin());
+    }
+}
+template <typename T, size_t NodeMaxSize, size_t MaxNodes>
+void inplace_unrolled_list<T, NodeMaxSize, MaxNodes>::clear() noexcept {
+    while (head) {
+        std::destroy(head->arr(), head->arr() + head->end);
+        head->end = 0;
+        release_node(head);
+    }
+    capacity = 0;
+}
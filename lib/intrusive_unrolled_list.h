@@ -0,0 +1,145 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "unrolled_list.h"
+
+// Iterator of intrusive_unrolled_list: walks the spine of pointers like my_iterator and
+// dereferences through them. Every step also prefetches the object `prefetch_distance`
+// slots ahead, looking into the next node when the current one runs out, so the
+// pointees are on their way to the cache by the time the loop reaches them.
+template <typename T, size_t NodeMaxSize, bool IsConst>
+class intrusive_iterator {
+    template <typename, size_t, typename>
+    friend class intrusive_unrolled_list;
+    template <typename, size_t, bool>
+    friend class intrusive_iterator;
+
+    typedef basic_iterator<node<T*, NodeMaxSize>, IsConst, false> base_iterator;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    typedef T value_type;
+    typedef std::conditional_t<IsConst, const T*, T*> pointer;
+    typedef std::conditional_t<IsConst, const T&, T&> reference;
+    typedef std::ptrdiff_t difference_type;
+
+    static constexpr size_t prefetch_distance = 8;
+
+    inline intrusive_iterator() = default;
+    inline explicit intrusive_iterator(base_iterator it) : base(it) {}
+    inline intrusive_iterator(const intrusive_iterator& other) = default;
+    inline intrusive_iterator& operator=(const intrusive_iterator& other) = default;
+    inline intrusive_iterator(const intrusive_iterator<T, NodeMaxSize, false>& other)
+        requires(IsConst)
+        : base(other.base) {}
+
+    inline bool operator==(const intrusive_iterator& other) const { return base == other.base; }
+    inline reference operator*() const { return **base; }
+    inline pointer operator->() const { return *base; }
+    inline intrusive_iterator& operator++() {
+        ++base;
+        prefetch(prefetch_distance);
+        return *this;
+    }
+    inline intrusive_iterator operator++(int) {
+        intrusive_iterator temp = *this;
+        ++*this;
+        return temp;
+    }
+    inline intrusive_iterator& operator--() {
+        --base;
+        return *this;
+    }
+    inline intrusive_iterator operator--(int) {
+        intrusive_iterator temp = *this;
+        --base;
+        return temp;
+    }
+
+   private:
+    // Prefetches the pointee `ahead` slots past the current one.
+    inline void prefetch(size_t ahead) const {
+        if (!base.ptr) {
+            return;
+        }
+        size_t left = base.node_end - base.cur;
+        if (ahead < left) {
+            __builtin_prefetch(base.cur[ahead]);
+        } else if (base.ptr->next && ahead - left < base.ptr->next->end) {
+            __builtin_prefetch(base.ptr->next->at(ahead - left));
+        }
+    }
+    // Issues the first prefetch_distance prefetches at once when a walk starts.
+    inline intrusive_iterator& prime() {
+        for (size_t i = 0; i < prefetch_distance; ++i) {
+            prefetch(i);
+        }
+        return *this;
+    }
+
+    base_iterator base;
+};
+
+// Unrolled list of objects owned elsewhere. Nodes keep T* densely, so the spine keeps its
+// cache-friendly layout while the objects are neither copied nor moved; inserting one is a
+// pointer store and only allocates when a node fills up (spare nodes absorb even that).
+// The caller keeps every object alive for as long as it is in the list.
+template <typename T, size_t NodeMaxSize = 32, typename Allocator = std::allocator<T*>>
+class intrusive_unrolled_list {
+   public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef intrusive_iterator<T, NodeMaxSize, false> iterator;
+    typedef intrusive_iterator<T, NodeMaxSize, true> const_iterator;
+    typedef unrolled_list<T*, NodeMaxSize, Allocator> spine_type;
+
+    intrusive_unrolled_list() = default;
+    explicit intrusive_unrolled_list(const Allocator& al) : spine(al) {}
+
+    inline iterator begin() { return iterator(spine.begin()).prime(); }
+    inline iterator end() { return iterator(spine.end()); }
+    inline const_iterator begin() const { return const_iterator(spine.cbegin()).prime(); }
+    inline const_iterator end() const { return const_iterator(spine.cend()); }
+    inline const_iterator cbegin() const { return begin(); }
+    inline const_iterator cend() const { return end(); }
+
+    inline size_t size() const { return spine.size(); }
+    inline bool empty() const { return spine.empty(); }
+    inline T& front() { return *spine.front(); }
+    inline T& back() { return *spine.back(); }
+    inline const T& front() const { return *spine.front(); }
+    inline const T& back() const { return *spine.back(); }
+    // the pointers themselves, e.g. to sort or hash them
+    inline const spine_type& pointers() const { return spine; }
+
+    // Temporaries would dangle, so only lvalues can be linked in.
+    inline void push_back(T& obj) { spine.push_back(&obj); }
+    inline void push_front(T& obj) { spine.push_front(&obj); }
+    inline iterator insert(const_iterator pos, T& obj) {
+        return iterator(spine.insert(pos.base, &obj));
+    }
+    void push_back(T&&) = delete;
+    void push_front(T&&) = delete;
+    iterator insert(const_iterator, T&&) = delete;
+
+    // Unlink objects from the list; the objects themselves are left untouched.
+    inline iterator erase(const_iterator pos) { return iterator(spine.erase(pos.base)); }
+    inline iterator erase(const_iterator first, const_iterator last) {
+        return iterator(spine.erase(first.base, last.base));
+    }
+    inline void pop_back() { spine.pop_back(); }
+    inline void pop_front() { spine.pop_front(); }
+    inline void clear() noexcept { spine.clear(); }
+
+    inline void set_spare_nodes(size_t limit) noexcept { spine.set_spare_nodes(limit); }
+    inline void reserve_nodes(size_t count) { spine.reserve_nodes(count); }
+
+   private:
+    spine_type spine;
+};
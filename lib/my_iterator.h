@@ -1,482 +1,267 @@
+#pragma once
+#include <compare>
 #include <iterator>
 #include <memory>
+#include <type_traits>
 
 #include "node.h"
 
-template <typename T, size_t NodeMaxSize>
-class my_iterator {
-    template <typename, size_t, typename>
+// One iterator for all four flavours. It caches the current slot and the end of the
+// node's segment, so ++ is a pointer increment plus one well-predicted compare and
+// dereferencing needs no indexing. A forward iterator points at its element and
+// `node_end` is arr() + end; a reverse one points one past its element and `node_end`
+// is arr(), so both walk towards `node_end` and hop to the neighbour node there. Any node
+// type with `arr()`, `end`, `next` and `prev` works, fixed-size or runtime-sized.
+template <typename Node, bool IsConst, bool IsReverse>
+class basic_iterator {
+    template <typename, size_t, typename, typename>
     friend class unrolled_list;
+    template <typename, size_t, size_t>
+    friend class inplace_unrolled_list;
+    template <typename, typename>
+    friend class dynamic_unrolled_list;
+    template <typename, bool, bool>
+    friend class basic_iterator;
+    template <typename, size_t, bool>
+    friend class intrusive_iterator;
 
-   public:
-    using iterator_category = std::bidirectional_iterator_tag;
-    typedef T* pointer;
-    typedef T& reference;
-    typedef const T& const_reference;
-    typedef std::ptrdiff_t difference_type;
-
-    inline my_iterator() : ptr(nullptr), current(0){};
-    inline my_iterator(node<T, NodeMaxSize>* obj) : ptr(obj), current(0){};
-    inline my_iterator(node<T, NodeMaxSize>* obj, size_t index) : ptr(obj), current(index){};
-    inline my_iterator& operator=(T* p) {
-        this->ptr = p;
-        return *this;
-    }
-    inline my_iterator(const my_iterator& other) : ptr(other.ptr), current(other.current) {}
-    ~my_iterator() = default;
-    inline bool operator!=(const my_iterator& other) const { return !(this->operator==(other)); }
-    inline bool operator==(const my_iterator& other) const {
-        return ptr == other.ptr && current == other.current;
-    }
-    inline reference operator*() const { return ptr->at(current); }
-    inline pointer operator->() const { return &(ptr->at(current)); }
-    my_iterator operator++(int);
-    my_iterator operator--(int);
-    my_iterator& operator++();
-    my_iterator& operator--();
-    my_iterator& operator+(size_t n);
-    my_iterator& operator-(size_t n);
-    difference_type operator-(const my_iterator&);
-
-   private:
-    node<T, NodeMaxSize>* ptr;
-    size_t current;
-};
-
-template <typename T, size_t NodeMaxSize>
-class my_const_iterator {
-    template <typename, size_t, typename>
-    friend class unrolled_list;
+    typedef typename Node::value_type T;
+    typedef std::conditional_t<IsConst, const Node, Node> node_type;
 
    public:
     using iterator_category = std::bidirectional_iterator_tag;
-    typedef const T* pointer;
-    typedef const T& reference;
+    typedef T value_type;
+    typedef std::conditional_t<IsConst, const T*, T*> pointer;
+    typedef std::conditional_t<IsConst, const T&, T&> reference;
     typedef const T& const_reference;
     typedef std::ptrdiff_t difference_type;
 
-    inline my_const_iterator() : ptr(nullptr){};
-    inline my_const_iterator(const node<T, NodeMaxSize>* obj) : ptr(obj){};
-    inline my_const_iterator(const node<T, NodeMaxSize>* obj, size_t index)
-        : ptr(obj), current(index){};
+    inline constexpr basic_iterator() : ptr(nullptr), cur(nullptr), node_end(nullptr){};
+    inline constexpr basic_iterator(node_type* obj) : basic_iterator(obj, 0){};
+    // `index` is a position in the node: the element itself for forward iterators,
+    // the slot past the element for reverse ones (so (node, 0) is rend of that node).
+    constexpr basic_iterator(node_type* obj, size_t index);
+    inline constexpr basic_iterator(const basic_iterator& other) = default;
+    inline constexpr basic_iterator(const basic_iterator<Node, false, IsReverse>& other)
+        requires(IsConst)
+        : ptr(other.ptr), cur(other.cur), node_end(other.node_end) {}
+    constexpr basic_iterator& operator=(const basic_iterator& other) = default;
+    constexpr ~basic_iterator() = default;
 
-    inline my_const_iterator& operator=(T* p) {
-        this->ptr = p;
-        return *this;
-    }
-    inline my_const_iterator(const my_const_iterator& other)
-        : ptr(other.ptr), current(other.current) {}
-    ~my_const_iterator() = default;
-    inline bool operator!=(const my_const_iterator& other) const {
+    inline constexpr bool operator!=(const basic_iterator& other) const {
         return !(this->operator==(other));
     }
-    inline bool operator==(const my_const_iterator& other) const {
-        return ptr == other.ptr && current == other.current;
-    }
-    inline reference operator*() const { return ptr->at(current); }
-    inline pointer operator->() const { return &(ptr->at(current)); }
-    my_const_iterator operator++(int);
-    my_const_iterator operator--(int);
-    my_const_iterator& operator++();
-    my_const_iterator& operator--();
-    my_const_iterator& operator+(size_t n);
-    my_const_iterator& operator-(size_t n);
-    difference_type operator-(const my_const_iterator&);
+    inline constexpr bool operator==(const basic_iterator& other) const {
+        // slots of different nodes never alias, but constant evaluation refuses to
+        // compare pointers into unrelated allocations
+        if consteval {
+            return ptr == other.ptr && cur == other.cur;
+        }
+        return cur == other.cur;
+    }
+    // True once the iterator has run off the last node, so a range can end in
+    // std::default_sentinel instead of a precomputed end().
+    inline constexpr bool operator==(std::default_sentinel_t) const {
+        if constexpr (IsReverse) {
+            return !ptr || (cur == node_end && !ptr->prev);
+        } else {
+            return !ptr || (cur == node_end && !ptr->next);
+        }
+    }
+    // List order. Nodes numbered in the same pass compare by ordinal in O(1), otherwise
+    // the chain is walked forward from this iterator's node.
+    constexpr std::strong_ordering operator<=>(const basic_iterator& other) const;
+    inline constexpr reference operator*() const {
+        if constexpr (IsReverse) {
+            return cur[-1];
+        } else {
+            return *cur;
+        }
+    }
+    inline constexpr pointer operator->() const { return &this->operator*(); }
+    constexpr basic_iterator operator++(int);
+    constexpr basic_iterator operator--(int);
+    constexpr basic_iterator& operator++();
+    constexpr basic_iterator& operator--();
+    constexpr basic_iterator operator+(size_t n) const;
+    constexpr basic_iterator operator-(size_t n) const;
+    constexpr difference_type operator-(const basic_iterator&) const;
 
    private:
-    const node<T, NodeMaxSize>* ptr;
-    size_t current;
-};
-
-template <typename T, size_t NodeMaxSize>
-class my_reverse_iterator {
-    template <typename, size_t, typename>
-    friend class unrolled_list;
+    inline constexpr size_t index() const { return cur - ptr->arr(); }
+    constexpr void step_forward();
+    constexpr void step_back();
 
-   public:
-    typedef T* pointer;
-    typedef T& reference;
-    typedef const T& const_reference;
-    typedef std::ptrdiff_t difference_type;
-    using iterator_category = std::bidirectional_iterator_tag;
-
-    inline my_reverse_iterator() : ptr(nullptr){};
-    inline my_reverse_iterator(node<T, NodeMaxSize>* obj) : ptr(obj){};
-    inline my_reverse_iterator(node<T, NodeMaxSize>* obj, size_t index)
-        : ptr(obj), current(index){};
-
-    inline my_reverse_iterator& operator=(T* p) {
-        this->ptr = p;
-        return *this;
-    }
-    inline my_reverse_iterator(const my_reverse_iterator& other)
-        : ptr(other.ptr), current(other.current) {}
-    ~my_reverse_iterator() = default;
-    inline bool operator!=(const my_reverse_iterator& other) const {
-        return !(this->operator==(other));
-    }
-    inline bool operator==(const my_reverse_iterator& other) const {
-        return ptr == other.ptr && current == other.current;
-    }
-    inline reference operator*() const { return ptr->at(current); }
-    inline pointer operator->() const { return &(ptr->at(current)); }
-    my_reverse_iterator operator++(int);
-    my_reverse_iterator operator--(int);
-    my_reverse_iterator& operator++();
-    my_reverse_iterator& operator--();
-    my_reverse_iterator& operator-(size_t n);
-    my_reverse_iterator& operator+(size_t n);
-    difference_type operator-(const my_reverse_iterator&);
-
-   private:
-    node<T, NodeMaxSize>* ptr;
-    size_t current;
+    node_type* ptr;
+    pointer cur;
+    pointer node_end;
 };
 
-template <typename T, size_t NodeMaxSize>
-class my_const_reverse_iterator {
-    template <typename, size_t, typename>
-    friend class unrolled_list;
-
+// Walks the node chain itself rather than the elements; backs nodes() and segments().
+template <typename Node>
+class node_iterator {
    public:
-    typedef const T* pointer;
-    typedef const T& reference;
-    typedef const T& const_reference;
+    using iterator_category = std::forward_iterator_tag;
+    typedef std::remove_const_t<Node> value_type;
+    typedef Node* pointer;
+    typedef Node& reference;
     typedef std::ptrdiff_t difference_type;
-    using iterator_category = std::bidirectional_iterator_tag;
-
-    inline my_const_reverse_iterator() : ptr(nullptr){};
-    inline my_const_reverse_iterator(const node<T, NodeMaxSize>* obj) : ptr(obj){};
-    inline my_const_reverse_iterator(const node<T, NodeMaxSize>* obj, size_t index)
-        : ptr(obj), current(index){};
 
-    inline my_const_reverse_iterator& operator=(T* p) {
-        this->ptr = p;
+    inline constexpr node_iterator() : ptr(nullptr){};
+    inline constexpr node_iterator(Node* obj) : ptr(obj){};
+    inline constexpr bool operator==(const node_iterator& other) const = default;
+    inline constexpr bool operator==(std::default_sentinel_t) const { return !ptr; }
+    inline constexpr reference operator*() const { return *ptr; }
+    inline constexpr pointer operator->() const { return ptr; }
+    inline constexpr node_iterator& operator++() {
+        ptr = ptr->next;
         return *this;
     }
-    inline my_const_reverse_iterator(const my_const_reverse_iterator& other)
-        : ptr(other.ptr), current(other.current) {}
-    ~my_const_reverse_iterator() = default;
-    inline bool operator!=(const my_const_reverse_iterator& other) const {
-        return !(this->operator==(other));
-    }
-    inline bool operator==(const my_const_reverse_iterator& other) const {
-        return ptr == other.ptr && current == other.current;
+    inline constexpr node_iterator operator++(int) {
+        node_iterator temp = *this;
+        ptr = ptr->next;
+        return temp;
     }
-    inline reference operator*() const { return ptr->at(current); }
-    inline pointer operator->() const { return &(ptr->at(current)); }
-    my_const_reverse_iterator operator++(int);
-    my_const_reverse_iterator operator--(int);
-    my_const_reverse_iterator& operator++();
-    my_const_reverse_iterator& operator--();
-    my_const_reverse_iterator& operator-(size_t n);
-    my_const_reverse_iterator& operator+(size_t n);
-    difference_type operator-(const my_const_reverse_iterator&);
 
    private:
-    const node<T, NodeMaxSize>* ptr;
-    size_t current;
+    Node* ptr;
 };
 
 template <typename T, size_t NodeMaxSize>
-struct std::iterator_traits<my_iterator<T, NodeMaxSize>> {
-    typedef std::ptrdiff_t difference_type;
-    typedef T value_type;
-    typedef T* pointer;
-    typedef T& reference;
-    typedef std::bidirectional_iterator_tag iterator_category;
-};
+using my_iterator = basic_iterator<node<T, NodeMaxSize>, false, false>;
 template <typename T, size_t NodeMaxSize>
-struct std::iterator_traits<my_const_iterator<T, NodeMaxSize>> {
-    typedef std::ptrdiff_t difference_type;
-    typedef const T value_type;
-    typedef const T* pointer;
-    typedef const T& reference;
-    typedef std::bidirectional_iterator_tag iterator_category;
-};
+using my_const_iterator = basic_iterator<node<T, NodeMaxSize>, true, false>;
 template <typename T, size_t NodeMaxSize>
-struct std::iterator_traits<my_reverse_iterator<T, NodeMaxSize>> {
-    typedef std::ptrdiff_t difference_type;
-    typedef T value_type;
-    typedef T* pointer;
-    typedef T& reference;
-    typedef std::bidirectional_iterator_tag iterator_category;
-};
+using my_reverse_iterator = basic_iterator<node<T, NodeMaxSize>, false, true>;
 template <typename T, size_t NodeMaxSize>
-struct std::iterator_traits<my_const_reverse_iterator<T, NodeMaxSize>> {
-    typedef std::ptrdiff_t difference_type;
-    typedef const T value_type;
-    typedef const T* pointer;
-    typedef const T& reference;
-    typedef std::bidirectional_iterator_tag iterator_category;
-};
+using my_const_reverse_iterator = basic_iterator<node<T, NodeMaxSize>, true, true>;
 
-template <typename T, size_t NodeMaxSize>
-my_iterator<T, NodeMaxSize> my_iterator<T, NodeMaxSize>::operator++(int) {
-    my_iterator<T, NodeMaxSize> temp = *this;
-    if (current < ptr->end || !ptr->next) {
-        ++current;
-    } else {
-        ptr = ptr->next;
-        current = 0;
-    }
-    return temp;
-}
-template <typename T, size_t NodeMaxSize>
-my_iterator<T, NodeMaxSize> my_iterator<T, NodeMaxSize>::operator--(int) {
-    my_iterator<T, NodeMaxSize> temp = *this;
-    if (current > 0 || !ptr->prev) {
-        --current;
-    } else {
-        ptr = ptr->prev;
-        current = ptr->end;
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr basic_iterator<Node, IsConst, IsReverse>::basic_iterator(node_type* obj,
+                                                                              size_t index)
+    : ptr(obj), cur(nullptr), node_end(nullptr) {
+    if (ptr) {
+        cur = ptr->arr() + index;
+        node_end = IsReverse ? ptr->arr() : ptr->arr() + ptr->end;
     }
-    return temp;
 }
-template <typename T, size_t NodeMaxSize>
-my_iterator<T, NodeMaxSize>& my_iterator<T, NodeMaxSize>::operator++() {
-    if (current < ptr->end - 1 || !ptr->next) {
-        ++current;
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr void basic_iterator<Node, IsConst, IsReverse>::step_forward() {
+    if constexpr (IsReverse) {
+        if (--cur == node_end && ptr->prev) {
+            ptr = ptr->prev;
+            cur = ptr->arr() + ptr->end;
+            node_end = ptr->arr();
+        }
     } else {
-        ptr = ptr->next;
-        current = 0;
+        if (++cur == node_end && ptr->next) {
+            ptr = ptr->next;
+            cur = ptr->arr();
+            node_end = ptr->arr() + ptr->end;
+        }
     }
-    return *this;
 }
-template <typename T, size_t NodeMaxSize>
-my_iterator<T, NodeMaxSize>& my_iterator<T, NodeMaxSize>::operator--() {
-    if (current > 0 || !ptr->prev) {
-        --current;
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr void basic_iterator<Node, IsConst, IsReverse>::step_back() {
+    if constexpr (IsReverse) {
+        if (cur == ptr->arr() + ptr->end && ptr->next) {
+            ptr = ptr->next;
+            cur = ptr->arr() + 1;
+            node_end = ptr->arr();
+        } else {
+            ++cur;
+        }
     } else {
-        ptr = ptr->prev;
-        current = ptr->end;
+        if (cur == ptr->arr() && ptr->prev) {
+            ptr = ptr->prev;
+            node_end = ptr->arr() + ptr->end;
+            cur = node_end - 1;
+        } else {
+            --cur;
+        }
     }
-    return *this;
 }
-template <typename T, size_t NodeMaxSize>
-my_iterator<T, NodeMaxSize>::difference_type my_iterator<T, NodeMaxSize>::operator-(
-    const my_iterator& other) {
-    my_iterator<T, NodeMaxSize> temp = *this;
-    size_t cnt = 1;
-    while (temp != other) {
-        ++temp;
-        ++cnt;
-    }
-    return cnt;
-}
-
-template <typename T, size_t NodeMaxSize>
-my_reverse_iterator<T, NodeMaxSize> my_reverse_iterator<T, NodeMaxSize>::operator++(int) {
-    my_reverse_iterator<T, NodeMaxSize> temp = *this;
-    if (current > 0 || !ptr->prev) {
-        --current;
-    } else {
-        ptr = ptr->prev;
-        current = ptr->end;
-    }
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr basic_iterator<Node, IsConst, IsReverse>
+basic_iterator<Node, IsConst, IsReverse>::operator++(int) {
+    basic_iterator temp = *this;
+    step_forward();
     return temp;
 }
-template <typename T, size_t NodeMaxSize>
-my_reverse_iterator<T, NodeMaxSize> my_reverse_iterator<T, NodeMaxSize>::operator--(int) {
-    my_reverse_iterator<T, NodeMaxSize> temp = *this;
-    if (current < ptr->end - 1 || !ptr->next) {
-        ++current;
-    } else {
-        ptr = ptr->next;
-        current = 0;
-    }
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr basic_iterator<Node, IsConst, IsReverse>
+basic_iterator<Node, IsConst, IsReverse>::operator--(int) {
+    basic_iterator temp = *this;
+    step_back();
     return temp;
 }
-template <typename T, size_t NodeMaxSize>
-my_reverse_iterator<T, NodeMaxSize>& my_reverse_iterator<T, NodeMaxSize>::operator++() {
-    if (current > 0 || !ptr->prev) {
-        --current;
-    } else {
-        ptr = ptr->prev;
-        current = ptr->end;
-    }
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr basic_iterator<Node, IsConst, IsReverse>&
+basic_iterator<Node, IsConst, IsReverse>::operator++() {
+    step_forward();
     return *this;
 }
-template <typename T, size_t NodeMaxSize>
-my_reverse_iterator<T, NodeMaxSize>& my_reverse_iterator<T, NodeMaxSize>::operator--() {
-    if (current < ptr->end - 1 || !ptr->next) {
-        ++current;
-    } else {
-        ptr = ptr->next;
-        current = 0;
-    }
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr basic_iterator<Node, IsConst, IsReverse>&
+basic_iterator<Node, IsConst, IsReverse>::operator--() {
+    step_back();
     return *this;
 }
-template <typename T, size_t NodeMaxSize>
-my_reverse_iterator<T, NodeMaxSize>::difference_type my_reverse_iterator<T, NodeMaxSize>::operator-(
-    const my_reverse_iterator& other) {
-    my_reverse_iterator<T, NodeMaxSize> temp = *this;
-    size_t cnt = 1;
-    while (temp != other) {
-        ++temp;
-        ++cnt;
-    }
-    return cnt;
-}
-template <typename T, size_t NodeMaxSize>
-my_reverse_iterator<T, NodeMaxSize>& my_reverse_iterator<T, NodeMaxSize>::operator-(size_t n) {
-    my_reverse_iterator res(*this);
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr basic_iterator<Node, IsConst, IsReverse>
+basic_iterator<Node, IsConst, IsReverse>::operator+(size_t n) const {
+    basic_iterator res(*this);
     for (size_t i = 0; i < n; ++i) {
         ++res;
     }
     return res;
 }
-template <typename T, size_t NodeMaxSize>
-my_reverse_iterator<T, NodeMaxSize>& my_reverse_iterator<T, NodeMaxSize>::operator+(size_t n) {
-    my_reverse_iterator res(*this);
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr basic_iterator<Node, IsConst, IsReverse>
+basic_iterator<Node, IsConst, IsReverse>::operator-(size_t n) const {
+    basic_iterator res(*this);
     for (size_t i = 0; i < n; ++i) {
         --res;
     }
     return res;
 }
-
-template <typename T, size_t NodeMaxSize>
-my_const_iterator<T, NodeMaxSize> my_const_iterator<T, NodeMaxSize>::operator++(int) {
-    my_const_iterator<T, NodeMaxSize> temp = *this;
-    if (current < ptr->end - 1 || !ptr->next) {
-        ++current;
-    } else {
-        ptr = ptr->next;
-        current = 0;
-    }
-    return temp;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_iterator<T, NodeMaxSize> my_const_iterator<T, NodeMaxSize>::operator--(int) {
-    my_const_iterator<T, NodeMaxSize> temp = *this;
-    if (current > 0 || !ptr->prev) {
-        --current;
-    } else {
-        ptr = ptr->prev;
-        current = ptr->end;
-    }
-    return temp;
-}
-
-template <typename T, size_t NodeMaxSize>
-my_const_iterator<T, NodeMaxSize>& my_const_iterator<T, NodeMaxSize>::operator++() {
-    if (current < ptr->end - 1 || !ptr->next) {
-        ++current;
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr std::strong_ordering basic_iterator<Node, IsConst, IsReverse>::operator<=>(
+    const basic_iterator& other) const {
+    if (ptr == other.ptr) {
+        return IsReverse ? other.cur <=> cur : cur <=> other.cur;
+    }
+    std::strong_ordering res = std::strong_ordering::greater;
+    if (ptr->stamp != 0 && ptr->stamp == other.ptr->stamp) {
+        res = ptr->ordinal <=> other.ptr->ordinal;
     } else {
-        ptr = ptr->next;
-        current = 0;
-    }
-    return *this;
+        for (node_type* temp = ptr->next; temp; temp = temp->next) {
+            if (temp == other.ptr) {
+                res = std::strong_ordering::less;
+                break;
+            }
+        }
+    }
+    return IsReverse ? 0 <=> res : res;
 }
-
-template <typename T, size_t NodeMaxSize>
-my_const_iterator<T, NodeMaxSize>& my_const_iterator<T, NodeMaxSize>::operator--() {
-    if (current > 0 || !ptr->prev) {
-        --current;
-    } else {
-        ptr = ptr->prev;
-        current = ptr->end;
-    }
-    return *this;
+// Distance from `other` up to this iterator, `other` being the earlier one. Whole nodes
+// in between are counted by their size instead of being walked element by element.
+template <typename Node, bool IsConst, bool IsReverse>
+constexpr basic_iterator<Node, IsConst, IsReverse>::difference_type
+basic_iterator<Node, IsConst, IsReverse>::operator-(const basic_iterator& other) const {
+    difference_type res = 0;
+    node_type* temp = other.ptr;
+    pointer from = other.cur;
+    while (temp != ptr) {
+        if constexpr (IsReverse) {
+            res += from - temp->arr();
+            temp = temp->prev;
+            from = temp->arr() + temp->end;
+        } else {
+            res += temp->arr() + temp->end - from;
+            temp = temp->next;
+            from = temp->arr();
+        }
+    }
+    return res + (IsReverse ? from - cur : cur - from);
 }
-template <typename T, size_t NodeMaxSize>
-my_const_iterator<T, NodeMaxSize>::difference_type my_const_iterator<T, NodeMaxSize>::operator-(
-    const my_const_iterator& other) {
-    my_const_iterator<T, NodeMaxSize> temp = *this;
-    size_t cnt = 1;
-    while (temp != other) {
-        ++temp;
-        ++cnt;
-    }
-    return cnt;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_iterator<T, NodeMaxSize>& my_const_iterator<T, NodeMaxSize>::operator+(size_t n) {
-    my_const_iterator res(*this);
-    for (size_t i = 0; i < n; ++i) {
-        ++res;
-    }
-    return res;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_iterator<T, NodeMaxSize>& my_const_iterator<T, NodeMaxSize>::operator-(size_t n) {
-    my_const_iterator res(*this);
-    for (size_t i = 0; i < n; ++i) {
-        --res;
-    }
-    return res;
-}
-
-template <typename T, size_t NodeMaxSize>
-my_const_reverse_iterator<T, NodeMaxSize> my_const_reverse_iterator<T, NodeMaxSize>::operator++(
-    int) {
-    my_const_reverse_iterator<T, NodeMaxSize> temp = *this;
-    if (current > 0 || !ptr->prev) {
-        --current;
-    } else {
-        ptr = ptr->prev;
-        current = ptr->end;
-    }
-    return temp;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_reverse_iterator<T, NodeMaxSize> my_const_reverse_iterator<T, NodeMaxSize>::operator--(
-    int) {
-    my_const_reverse_iterator<T, NodeMaxSize> temp = *this;
-    if (current < ptr->end - 1 || !ptr->next) {
-        ++current;
-    } else {
-        ptr = ptr->next;
-        current = 0;
-    }
-    return temp;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_reverse_iterator<T, NodeMaxSize>& my_const_reverse_iterator<T, NodeMaxSize>::operator++() {
-    if (current > 0 || !ptr->prev) {
-        --current;
-    } else {
-        ptr = ptr->prev;
-        current = ptr->end;
-    }
-    return *this;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_reverse_iterator<T, NodeMaxSize>& my_const_reverse_iterator<T, NodeMaxSize>::operator--() {
-    if (current < ptr->end - 1 || !ptr->next) {
-        ++current;
-    } else {
-        ptr = ptr->next;
-        current = 0;
-    }
-    return *this;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_reverse_iterator<T, NodeMaxSize>::difference_type
-my_const_reverse_iterator<T, NodeMaxSize>::operator-(const my_const_reverse_iterator& other) {
-    my_const_reverse_iterator<T, NodeMaxSize> temp = *this;
-    size_t cnt = 1;
-    while (temp != other) {
-        ++temp;
-        ++cnt;
-    }
-    return cnt;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_reverse_iterator<T, NodeMaxSize>& my_const_reverse_iterator<T, NodeMaxSize>::operator-(
-    size_t n) {
-    my_const_reverse_iterator res(*this);
-    for (size_t i = 0; i < n; ++i) {
-        ++res;
-    }
-    return res;
-}
-template <typename T, size_t NodeMaxSize>
-my_const_reverse_iterator<T, NodeMaxSize>& my_const_reverse_iterator<T, NodeMaxSize>::operator+(
-    size_t n) {
-    my_const_reverse_iterator res(*this);
-    for (size_t i = 0; i < n; ++i) {
-        --res;
-    }
-    return res;
-}
\ No newline at end of file
@@ -5,66 +5,130 @@
 #include <type_traits>
 #include <utility>
 
+template <typename T, size_t NodeMaxSize>
+struct node_slab;
+
 template <typename T, size_t NodeMaxSize>
 class node {
-    template <typename, size_t, typename>
+    template <typename, size_t, typename, typename>
     friend class unrolled_list;
-    template <typename, size_t>
-    friend class my_iterator;
-    template <typename, size_t>
-    friend class my_const_iterator;
-    template <typename, size_t>
-    friend class my_reverse_iterator;
-    template <typename, size_t>
-    friend class my_const_reverse_iterator;
+    template <typename, size_t, typename>
+    friend class chunk_tree;
+    template <typename, size_t, size_t>
+    friend class inplace_unrolled_list;
+    template <typename, bool, bool>
+    friend class basic_iterator;
+    template <typename, size_t, typename>
+    friend class timer_wheel;
 
    public:
-    node();
-    node(const T& value, size_t n = 1);
-    node(node<T, NodeMaxSize>*);
-    ~node();
-    T& at(const size_t&);
-    const T& at(const size_t&) const;
-    void link_forward(node*);
-    void link_back(node*);
-    inline void pop_back() {
-        if (end > 0) end--;
-    }
-    inline void pop_front() {
-        if (end > 0) *this << 1;
-        --end;
+    typedef T value_type;
+
+    constexpr node();
+    constexpr node(const T& value, size_t n = 1);
+    constexpr node(node<T, NodeMaxSize>*);
+    // a node owns its elements and its links; copying the bytes would duplicate both
+    node(const node&) = delete;
+    node& operator=(const node&) = delete;
+    constexpr ~node();
+    constexpr T& at(const size_t&);
+    constexpr const T& at(const size_t&) const;
+    constexpr void link_forward(node*);
+    constexpr void link_back(node*);
+    inline constexpr void pop_back() {
+        if (end > 0) {
+            std::destroy_at(arr() + --end);
+        }
+    }
+    inline constexpr void pop_front() {
+        if (end > 0) {
+            std::move(arr() + 1, arr() + end, arr());
+            std::destroy_at(arr() + --end);
+        }
     }
     void erase(size_t, size_t to = NodeMaxSize);
-    T& back();
-    T& front();
+    constexpr T& back();
+    constexpr T& front();
     void operator<<(size_t);
     void operator>>(size_t);
     node* next;
     node* prev;
     size_t end;
-    void thread_forward(node*);
-    void thread_back(node*);
+    constexpr void thread_forward(node*);
+    constexpr void thread_back(node*);
+    node_slab<T, NodeMaxSize>* slab;
+    // Position bookkeeping kept by unrolled_list: nodes numbered in the same pass share
+    // a non-zero `stamp` and are ordered by `ordinal`; `prefix` counts the elements in
+    // front of the node. Zero stamp means the node was never numbered.
+    size_t ordinal;
+    size_t prefix;
+    size_t stamp;
+    // An open gap: slots [gap_at, gap_at + gap_size) are free and the elements from
+    // gap_at on sit right after them, at the far end of the node. Consecutive inserts at
+    // gap_at fill it one slot at a time; close_gap moves the tail back down.
+    size_t gap_at;
+    size_t gap_size;
+    constexpr void open_gap(size_t at);
+    constexpr void close_gap();
 
    private:
-    alignas(T) std::byte storage[NodeMaxSize * sizeof(T)];
-    T* arr;
+    // Constant evaluation can't reinterpret `storage`, so a node built at compile
+    // time keeps its elements in a transient std::allocator block instead, and the
+    // address of that block takes the place of the storage bytes.
+    inline constexpr void make_storage() {
+        if consteval {
+            heap = std::allocator<T>().allocate(NodeMaxSize);
+        }
+    }
+    inline constexpr T* arr() {
+        if consteval {
+            return heap;
+        } else {
+            return reinterpret_cast<T*>(storage);
+        }
+    }
+    inline constexpr const T* arr() const {
+        if consteval {
+            return heap;
+        } else {
+            return reinterpret_cast<const T*>(storage);
+        }
+    }
+
+    union {
+        alignas(T) std::byte storage[NodeMaxSize * sizeof(T)];
+        T* heap;
+    };
 };
 
 template <typename T, size_t NodeMaxSize>
-node<T, NodeMaxSize>::node() {
-    arr = reinterpret_cast<T*>(storage);
+constexpr node<T, NodeMaxSize>::node() {
+    make_storage();
     next = nullptr;
     prev = nullptr;
+    slab = nullptr;
     end = 0;
+    ordinal = 0;
+    prefix = 0;
+    stamp = 0;
+    gap_at = 0;
+    gap_size = 0;
 }
 template <typename T, size_t NodeMaxSize>
-node<T, NodeMaxSize>::node(const T& value, size_t len) {
-    arr = reinterpret_cast<T*>(storage);
+constexpr node<T, NodeMaxSize>::node(const T& value, size_t len) {
+    make_storage();
+    next = nullptr;
+    prev = nullptr;
+    slab = nullptr;
     end = 0;
+    ordinal = 0;
+    prefix = 0;
+    stamp = 0;
+    gap_at = 0;
+    gap_size = 0;
     for (size_t i = 0; i < NodeMaxSize; i++) {
         if (len > 0) {
-            arr[i] = value;
-            std::construct_at(arr + i, value);
+            std::construct_at(arr() + i, value);
             ++end;
             --len;
         }
@@ -72,35 +136,46 @@ node<T, NodeMaxSize>::node(const T& value, size_t len) {
 }
 
 template <typename T, size_t NodeMaxSize>
-node<T, NodeMaxSize>::node(node<T, NodeMaxSize>* other) {  // should be complitetd
-    arr = reinterpret_cast<T*>(storage);
+constexpr node<T, NodeMaxSize>::node(node<T, NodeMaxSize>* other) {  // should be complitetd
+    make_storage();
+    next = nullptr;
+    prev = nullptr;
+    slab = nullptr;
     end = 0;
+    ordinal = 0;
+    prefix = 0;
+    stamp = 0;
+    gap_at = 0;
+    gap_size = 0;
     for (size_t i = 0; i < NodeMaxSize / 2; ++i) {
-        std::construct_at(arr + i, other->arr[NodeMaxSize / 2 + i]);
+        std::construct_at(arr() + i, other->arr()[NodeMaxSize / 2 + i]);
         ++end;
     }
     other->end = NodeMaxSize / 2;
 }
 
 template <typename T, size_t NodeMaxSize>
-node<T, NodeMaxSize>::~node() {
+constexpr node<T, NodeMaxSize>::~node() {
     for (size_t i = 0; i < end; ++i) {
-        std::destroy_at(arr + (sizeof(T) * i));
+        std::destroy_at(arr() + i);
+    }
+    if consteval {
+        std::allocator<T>().deallocate(arr(), NodeMaxSize);
     }
     next = nullptr;
     prev = nullptr;
 }
 
 template <typename T, size_t NodeMaxSize>
-T& node<T, NodeMaxSize>::at(const size_t& index) {
-    return arr[index];
+constexpr T& node<T, NodeMaxSize>::at(const size_t& index) {
+    return arr()[index];
 }
 template <typename T, size_t NodeMaxSize>
-const T& node<T, NodeMaxSize>::at(const size_t& index) const {
-    return arr[index];
+constexpr const T& node<T, NodeMaxSize>::at(const size_t& index) const {
+    return arr()[index];
 }
 template <typename T, size_t NodeMaxSize>
-void node<T, NodeMaxSize>::link_forward(node* other) {
+constexpr void node<T, NodeMaxSize>::link_forward(node* other) {
     if (this && other) {
         this->next = other;
         other->prev = this;
@@ -111,7 +186,7 @@ void node<T, NodeMaxSize>::link_forward(node* other) {
     }
 }
 template <typename T, size_t NodeMaxSize>
-void node<T, NodeMaxSize>::link_back(node* other) {
+constexpr void node<T, NodeMaxSize>::link_back(node* other) {
     if (this && other) {
         this->prev = other;
         other->next = this;
@@ -124,9 +199,9 @@ void node<T, NodeMaxSize>::link_back(node* other) {
 template <typename T, size_t NodeMaxSize>
 void node<T, NodeMaxSize>::operator<<(size_t shift) {
     shift %= NodeMaxSize;
-    std::reverse(arr, arr + shift);
-    std::reverse(arr + shift, arr + NodeMaxSize);
-    std::reverse(arr, arr + NodeMaxSize);
+    std::reverse(arr(), arr() + shift);
+    std::reverse(arr() + shift, arr() + NodeMaxSize);
+    std::reverse(arr(), arr() + NodeMaxSize);
 }
 template <typename T, size_t NodeMaxSize>
 void node<T, NodeMaxSize>::operator>>(size_t shift) {
@@ -135,28 +210,24 @@ void node<T, NodeMaxSize>::operator>>(size_t shift) {
 }
 
 template <typename T, size_t NodeMaxSize>
-void node<T, NodeMaxSize>::thread_forward(node* bufer) {
-    for (size_t i = NodeMaxSize / 2; i < NodeMaxSize - 1; ++i) {
-        if constexpr (std::is_assignable_v<T, T>) {
-            bufer->arr[bufer->end] = arr[i + 1];
-        } else {
-            std::construct_at(bufer->arr + bufer->end, arr[i + 1]);
-        }
+constexpr void node<T, NodeMaxSize>::thread_forward(node* bufer) {
+    // keeps at least one slot free, so a node of size 1 or 2 is not left full
+    size_t keep = std::min(NodeMaxSize / 2 + 1, NodeMaxSize - 1);
+    for (size_t i = keep; i < end; ++i) {
+        std::construct_at(bufer->arr() + bufer->end, std::move(arr()[i]));
+        std::destroy_at(arr() + i);
         ++bufer->end;
     }
-    end = NodeMaxSize / 2 + 1;
+    end = keep;
 
     bufer->link_forward(this->next);
     this->link_forward(bufer);
 }
 template <typename T, size_t NodeMaxSize>  // pay attention
-void node<T, NodeMaxSize>::thread_back(node* bufer) {
-    for (size_t i = NodeMaxSize / 2; i < NodeMaxSize; ++i) {
-        if constexpr (std::is_assignable_v<T, T>) {
-            bufer->arr[bufer->end] = arr[i];
-        } else {
-            std::construct_at(bufer->arr + bufer->end, arr[i]);
-        }
+constexpr void node<T, NodeMaxSize>::thread_back(node* bufer) {
+    for (size_t i = NodeMaxSize / 2; i < end; ++i) {
+        std::construct_at(bufer->arr() + bufer->end, std::move(arr()[i]));
+        std::destroy_at(arr() + i);
         ++bufer->end;
     }
     end = (NodeMaxSize / 2);
@@ -164,21 +235,51 @@ void node<T, NodeMaxSize>::thread_back(node* bufer) {
     this->link_forward(bufer);
 }
 template <typename T, size_t NodeMaxSize>
-T& node<T, NodeMaxSize>::front() {
-    return arr[0];
+constexpr void node<T, NodeMaxSize>::open_gap(size_t at) {
+    gap_size = NodeMaxSize - end;
+    for (size_t i = end; i > at; --i) {
+        std::construct_at(arr() + i - 1 + gap_size, std::move(arr()[i - 1]));
+        std::destroy_at(arr() + i - 1);
+    }
+    gap_at = at;
 }
 template <typename T, size_t NodeMaxSize>
-T& node<T, NodeMaxSize>::back() {
-    return arr[end - 1];
+constexpr void node<T, NodeMaxSize>::close_gap() {
+    if (gap_size == 0) {
+        return;
+    }
+    for (size_t i = gap_at; i < end; ++i) {
+        std::construct_at(arr() + i, std::move(arr()[i + gap_size]));
+        std::destroy_at(arr() + i + gap_size);
+    }
+    gap_size = 0;
+}
+template <typename T, size_t NodeMaxSize>
+constexpr T& node<T, NodeMaxSize>::front() {
+    return arr()[0];
+}
+template <typename T, size_t NodeMaxSize>
+constexpr T& node<T, NodeMaxSize>::back() {
+    return arr()[end - 1];
 }
 template <typename T, size_t NodeMaxSize>
 void node<T, NodeMaxSize>::erase(size_t from, size_t to) {
     for (size_t i = to; i >= from; ++i) {
-        std::destroy_at(arr[to]);
+        std::destroy_at(arr()[to]);
         --end;
     }
     if (to != NodeMaxSize) {
-        std::reverse(arr + to + 1, arr + NodeMaxSize);
-        std::reverse(arr + from, arr + NodeMaxSize);
+        std::reverse(arr() + to + 1, arr() + NodeMaxSize);
+        std::reverse(arr() + from, arr() + NodeMaxSize);
     }
 }
+
+// A batch of nodes obtained from one allocation. Nodes handed out from a slab are
+// not deallocated one by one: the whole slab is returned once the last of them dies.
+template <typename T, size_t NodeMaxSize>
+struct node_slab {
+    node<T, NodeMaxSize>* base;
+    size_t size;
+    size_t used;
+    size_t live;
+};
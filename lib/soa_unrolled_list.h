@@ -0,0 +1,483 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Structure-of-arrays flavour of node: every member of the tuple-like T lives in an array
+// of its own, so a scan over one member touches only that member's bytes.
+template <typename T, size_t NodeMaxSize>
+class soa_node {
+    template <size_t I>
+    using element = std::tuple_element_t<I, T>;
+    static constexpr size_t columns = std::tuple_size_v<T>;
+
+    template <typename E>
+    struct column_storage {
+        alignas(E) std::byte bytes[NodeMaxSize * sizeof(E)];
+    };
+    template <typename Indices>
+    struct storage_for;
+    template <size_t... I>
+    struct storage_for<std::index_sequence<I...>> {
+        typedef std::tuple<column_storage<element<I>>...> type;
+    };
+
+   public:
+    soa_node();
+    ~soa_node();
+
+    template <size_t I>
+    inline element<I>* column() {
+        return reinterpret_cast<element<I>*>(std::get<I>(storage).bytes);
+    }
+    template <size_t I>
+    inline const element<I>* column() const {
+        return reinterpret_cast<const element<I>*>(std::get<I>(storage).bytes);
+    }
+    template <typename F>
+    inline void for_each_column(F&& f) {
+        for_each_column(std::forward<F>(f), std::make_index_sequence<columns>());
+    }
+
+    T get(size_t) const;
+    void set(size_t, const T&);
+    void insert(size_t, const T&);
+    void erase(size_t);
+
+    void link_forward(soa_node*);
+    void thread_forward(soa_node*);
+    void thread_back(soa_node*);
+
+    soa_node* next;
+    soa_node* prev;
+    size_t end;
+
+   private:
+    template <typename F, size_t... I>
+    inline void for_each_column(F&& f, std::index_sequence<I...>) {
+        (f(column<I>()), ...);
+    }
+    template <size_t... I>
+    inline T get(size_t index, std::index_sequence<I...>) const {
+        return T{column<I>()[index]...};
+    }
+    void move_tail(soa_node*, size_t from);
+
+    typename storage_for<std::make_index_sequence<columns>>::type storage;
+};
+
+template <typename T, size_t NodeMaxSize>
+soa_node<T, NodeMaxSize>::soa_node() {
+    next = nullptr;
+    prev = nullptr;
+    end = 0;
+}
+template <typename T, size_t NodeMaxSize>
+soa_node<T, NodeMaxSize>::~soa_node() {
+    for_each_column([this](auto* column) { std::destroy(column, column + end); });
+    next = nullptr;
+    prev = nullptr;
+}
+template <typename T, size_t NodeMaxSize>
+T soa_node<T, NodeMaxSize>::get(size_t index) const {
+    return get(index, std::make_index_sequence<columns>());
+}
+template <typename T, size_t NodeMaxSize>
+void soa_node<T, NodeMaxSize>::set(size_t index, const T& value) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        using std::get;
+        ((column<I>()[index] = get<I>(value)), ...);
+    }(std::make_index_sequence<columns>());
+}
+template <typename T, size_t NodeMaxSize>
+void soa_node<T, NodeMaxSize>::insert(size_t index, const T& value) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        using std::get;
+        // every member is copied before any column moves, so a throwing copy leaves the
+        // columns in step
+        std::tuple<element<I>...> parts(get<I>(value)...);
+        auto shift = [&](auto* column, auto& part) {
+            if (index == end) {
+                std::construct_at(column + end, std::move(part));
+                return;
+            }
+            std::construct_at(column + end, std::move(column[end - 1]));
+            std::move_backward(column + index, column + end - 1, column + end);
+            column[index] = std::move(part);
+        };
+        (shift(column<I>(), get<I>(parts)), ...);
+    }(std::make_index_sequence<columns>());
+    ++end;
+}
+template <typename T, size_t NodeMaxSize>
+void soa_node<T, NodeMaxSize>::erase(size_t index) {
+    for_each_column([&](auto* column) {
+        std::move(column + index + 1, column + end, column + index);
+        std::destroy_at(column + end - 1);
+    });
+    --end;
+}
+template <typename T, size_t NodeMaxSize>
+void soa_node<T, NodeMaxSize>::link_forward(soa_node* other) {
+    next = other;
+    if (other) {
+        other->prev = this;
+    }
+}
+template <typename T, size_t NodeMaxSize>
+void soa_node<T, NodeMaxSize>::move_tail(soa_node* bufer, size_t from) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        auto move = [&](auto* source, auto* target) {
+            for (size_t i = from; i < end; ++i) {
+                std::construct_at(target + bufer->end + i - from, std::move(source[i]));
+                std::destroy_at(source + i);
+            }
+        };
+        (move(column<I>(), bufer->template column<I>()), ...);
+    }(std::make_index_sequence<columns>());
+    bufer->end += end - from;
+    end = from;
+    bufer->link_forward(next);
+    link_forward(bufer);
+}
+template <typename T, size_t NodeMaxSize>
+void soa_node<T, NodeMaxSize>::thread_forward(soa_node* bufer) {
+    // at least one element moves, or a full node of one or two elements stays full
+    move_tail(bufer, std::min(NodeMaxSize / 2 + 1, NodeMaxSize - 1));
+}
+template <typename T, size_t NodeMaxSize>
+void soa_node<T, NodeMaxSize>::thread_back(soa_node* bufer) {
+    move_tail(bufer, NodeMaxSize / 2);
+}
+
+// Proxy returned by soa iterators: reads assemble a T out of the columns,
+// writes scatter it back. get<I>() reaches a single member in place.
+template <typename T, size_t NodeMaxSize, bool IsConst>
+class soa_reference {
+    typedef std::conditional_t<IsConst, const soa_node<T, NodeMaxSize>, soa_node<T, NodeMaxSize>>
+        node_type;
+
+   public:
+    inline soa_reference(node_type* obj, size_t index) : ptr(obj), current(index) {}
+    inline operator T() const { return ptr->get(current); }
+    inline const soa_reference& operator=(const T& value) const
+        requires(!IsConst)
+    {
+        ptr->set(current, value);
+        return *this;
+    }
+    template <size_t I>
+    inline auto& get() const {
+        return ptr->template column<I>()[current];
+    }
+    inline bool operator==(const T& value) const { return T(*this) == value; }
+
+   private:
+    node_type* ptr;
+    size_t current;
+};
+
+template <typename T, size_t NodeMaxSize, bool IsConst>
+class soa_iterator {
+    template <typename, size_t, typename>
+    friend class soa_unrolled_list;
+    typedef std::conditional_t<IsConst, const soa_node<T, NodeMaxSize>, soa_node<T, NodeMaxSize>>
+        node_type;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    typedef T value_type;
+    typedef soa_reference<T, NodeMaxSize, IsConst> reference;
+    typedef void pointer;
+    typedef std::ptrdiff_t difference_type;
+
+    inline soa_iterator() : ptr(nullptr), current(0) {}
+    inline soa_iterator(node_type* obj, size_t index) : ptr(obj), current(index) {}
+    inline operator soa_iterator<T, NodeMaxSize, true>() const { return {ptr, current}; }
+
+    inline reference operator*() const { return reference(ptr, current); }
+    inline bool operator==(const soa_iterator& other) const {
+        return ptr == other.ptr && current == other.current;
+    }
+    inline bool operator!=(const soa_iterator& other) const { return !(*this == other); }
+    soa_iterator& operator++();
+    soa_iterator& operator--();
+    inline soa_iterator operator++(int) {
+        soa_iterator temp = *this;
+        ++*this;
+        return temp;
+    }
+    inline soa_iterator operator--(int) {
+        soa_iterator temp = *this;
+        --*this;
+        return temp;
+    }
+
+   private:
+    node_type* ptr;
+    size_t current;
+};
+
+template <typename T, size_t NodeMaxSize, bool IsConst>
+soa_iterator<T, NodeMaxSize, IsConst>& soa_iterator<T, NodeMaxSize, IsConst>::operator++() {
+    if (current + 1 < ptr->end || !ptr->next) {
+        ++current;
+    } else {
+        ptr = ptr->next;
+        current = 0;
+    }
+    return *this;
+}
+template <typename T, size_t NodeMaxSize, bool IsConst>
+soa_iterator<T, NodeMaxSize, IsConst>& soa_iterator<T, NodeMaxSize, IsConst>::operator--() {
+    if (current > 0 || !ptr->prev) {
+        --current;
+    } else {
+        ptr = ptr->prev;
+        current = ptr->end - 1;
+    }
+    return *this;
+}
+
+// Range over the nodes of a soa_unrolled_list yielding one std::span per node
+// for a single column.
+template <typename T, size_t NodeMaxSize, size_t I, bool IsConst>
+class soa_column_view {
+    typedef std::conditional_t<IsConst, const soa_node<T, NodeMaxSize>, soa_node<T, NodeMaxSize>>
+        node_type;
+    typedef std::conditional_t<IsConst, const std::tuple_element_t<I, T>,
+                               std::tuple_element_t<I, T>>
+        element_type;
+
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        typedef std::span<element_type> value_type;
+        typedef std::span<element_type> reference;
+        typedef void pointer;
+        typedef std::ptrdiff_t difference_type;
+
+        inline iterator() : ptr(nullptr) {}
+        inline iterator(node_type* obj) : ptr(obj) {}
+        inline reference operator*() const {
+            return reference(ptr->template column<I>(), ptr->end);
+        }
+        inline iterator& operator++() {
+            ptr = ptr->next;
+            return *this;
+        }
+        inline iterator operator++(int) {
+            iterator temp = *this;
+            ptr = ptr->next;
+            return temp;
+        }
+        inline bool operator==(const iterator& other) const { return ptr == other.ptr; }
+        inline bool operator!=(const iterator& other) const { return ptr != other.ptr; }
+
+       private:
+        node_type* ptr;
+    };
+
+    inline soa_column_view(node_type* first) : head(first) {}
+    inline iterator begin() const { return iterator(head); }
+    inline iterator end() const { return iterator(); }
+
+   private:
+    node_type* head;
+};
+
+template <typename T, size_t NodeMaxSize = 10, typename Allocator = std::allocator<T>>
+class soa_unrolled_list {
+   public:
+    typedef T value_type;
+    typedef soa_reference<T, NodeMaxSize, false> reference;
+    typedef soa_reference<T, NodeMaxSize, true> const_reference;
+    typedef std::ptrdiff_t difference_type;
+    typedef size_t size_type;
+    typedef soa_iterator<T, NodeMaxSize, false> iterator;
+    typedef soa_iterator<T, NodeMaxSize, true> const_iterator;
+    typedef Allocator allocator_type;
+
+    typedef
+        typename std::allocator_traits<Allocator>::template rebind_alloc<soa_node<T, NodeMaxSize>>
+            allocatorNode;
+
+    soa_unrolled_list();
+    soa_unrolled_list(const Allocator&);
+    soa_unrolled_list(const soa_unrolled_list&) = delete;
+    soa_unrolled_list& operator=(const soa_unrolled_list&) = delete;
+    ~soa_unrolled_list();
+
+    inline iterator begin() { return iterator(head, 0); }
+    inline iterator end() { return iterator(tail, tail->end); }
+    inline const_iterator begin() const { return const_iterator(head, 0); }
+    inline const_iterator end() const { return const_iterator(tail, tail->end); }
+    inline const_iterator cbegin() const { return const_iterator(head, 0); }
+    inline const_iterator cend() const { return const_iterator(tail, tail->end); }
+
+    template <size_t I>
+    inline soa_column_view<T, NodeMaxSize, I, false> column() {
+        return soa_column_view<T, NodeMaxSize, I, false>(head);
+    }
+    template <size_t I>
+    inline soa_column_view<T, NodeMaxSize, I, true> column() const {
+        return soa_column_view<T, NodeMaxSize, I, true>(head);
+    }
+
+    inline size_t size() const { return capacity; }
+    inline bool empty() const { return capacity == 0; }
+    inline allocator_type get_allocator() const { return alloc; }
+
+    inline reference front() { return reference(head, 0); }
+    inline reference back() { return reference(tail, tail->end - 1); }
+    inline const_reference front() const { return const_reference(head, 0); }
+    inline const_reference back() const { return const_reference(tail, tail->end - 1); }
+
+    iterator insert(const_iterator, const T&);
+    iterator erase(const_iterator) noexcept;
+    void push_back(const T&);
+    void push_front(const T&);
+    void pop_back() noexcept;
+    void pop_front() noexcept;
+    void clear() noexcept;
+
+   private:
+    soa_node<T, NodeMaxSize>* create_node();
+    void unlink(soa_node<T, NodeMaxSize>*) noexcept;
+
+    soa_node<T, NodeMaxSize>* head;
+    soa_node<T, NodeMaxSize>* tail;
+
+    allocatorNode alloc;
+    size_t capacity;
+    size_t node_capacity;
+};
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+soa_unrolled_list<T, NodeMaxSize, Allocator>::soa_unrolled_list() : soa_unrolled_list(Allocator()) {}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+soa_unrolled_list<T, NodeMaxSize, Allocator>::soa_unrolled_list(const Allocator& al) : alloc(al) {
+    capacity = 0;
+    node_capacity = 0;
+    head = create_node();
+    tail = head;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+soa_unrolled_list<T, NodeMaxSize, Allocator>::~soa_unrolled_list() {
+    while (head) {
+        soa_node<T, NodeMaxSize>* temp = head->next;
+        std::allocator_traits<allocatorNode>::destroy(alloc, head);
+        alloc.deallocate(head, 1);
+        head = temp;
+    }
+    tail = nullptr;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+soa_node<T, NodeMaxSize>* soa_unrolled_list<T, NodeMaxSize, Allocator>::create_node() {
+    soa_node<T, NodeMaxSize>* result = alloc.allocate(1);
+    std::allocator_traits<allocatorNode>::construct(alloc, result);
+    ++node_capacity;
+    return result;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void soa_unrolled_list<T, NodeMaxSize, Allocator>::unlink(soa_node<T, NodeMaxSize>* target) noexcept {
+    if (target->prev) {
+        target->prev->next = target->next;
+    } else {
+        head = target->next;
+    }
+    if (target->next) {
+        target->next->prev = target->prev;
+    } else {
+        tail = target->prev;
+    }
+    std::allocator_traits<allocatorNode>::destroy(alloc, target);
+    alloc.deallocate(target, 1);
+    --node_capacity;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+soa_iterator<T, NodeMaxSize, false> soa_unrolled_list<T, NodeMaxSize, Allocator>::insert(
+    const_iterator point, const T& value) {
+    iterator it(const_cast<soa_node<T, NodeMaxSize>*>(point.ptr), point.current);
+    if (it.ptr->end == NodeMaxSize) {
+        soa_node<T, NodeMaxSize>* bufer = create_node();
+        it.ptr->thread_forward(bufer);
+        if (tail == it.ptr) {
+            tail = bufer;
+        }
+        if (it.current > it.ptr->end) {
+            it.current -= it.ptr->end;
+            it.ptr = bufer;
+        }
+    }
+    it.ptr->insert(it.current, value);
+    ++capacity;
+    return it;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+soa_iterator<T, NodeMaxSize, false> soa_unrolled_list<T, NodeMaxSize, Allocator>::erase(
+    const_iterator point) noexcept {
+    iterator it(const_cast<soa_node<T, NodeMaxSize>*>(point.ptr), point.current);
+    it.ptr->erase(it.current);
+    --capacity;
+    if (it.ptr->end == 0 && node_capacity > 1) {
+        soa_node<T, NodeMaxSize>* following = it.ptr->next;
+        unlink(it.ptr);
+        return following ? iterator(following, 0) : end();
+    }
+    if (it.current == it.ptr->end && it.ptr->next) {
+        return iterator(it.ptr->next, 0);
+    }
+    return it;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void soa_unrolled_list<T, NodeMaxSize, Allocator>::push_back(const T& value) {
+    if (tail->end == NodeMaxSize) {
+        soa_node<T, NodeMaxSize>* bufer = create_node();
+        tail->thread_forward(bufer);
+        tail = bufer;
+    }
+    tail->insert(tail->end, value);
+    ++capacity;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void soa_unrolled_list<T, NodeMaxSize, Allocator>::push_front(const T& value) {
+    if (head->end == NodeMaxSize) {
+        soa_node<T, NodeMaxSize>* bufer = create_node();
+        head->thread_back(bufer);
+        if (tail == head) {
+            tail = bufer;
+        }
+    }
+    head->insert(0, value);
+    ++capacity;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void soa_unrolled_list<T, NodeMaxSize, Allocator>::pop_back() noexcept {
+    if (capacity != 0) {
+        erase(const_iterator(tail, tail->end - 1));
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void soa_unrolled_list<T, NodeMaxSize, Allocator>::pop_front() noexcept {
+    if (capacity != 0) {
+        erase(const_iterator(head, 0));
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void soa_unrolled_list<T, NodeMaxSize, Allocator>::clear() noexcept {
+    while (head != tail) {
+        unlink(tail);
+    }
+    head->for_each_column([this](auto* column) { std::destroy(column, column + head->end); });
+    head->end = 0;
+    capacity = 0;
+}
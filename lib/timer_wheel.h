@@ -0,0 +1,322 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "node.h"
+
+template <typename T>
+struct timer_entry {
+    uint64_t deadline;
+    T value;
+};
+
+// Hierarchical timing wheel whose buckets are chains of unrolled nodes. Level L has 64
+// slots of 64^L ticks each; an entry sits on the level of the highest base-64 digit in
+// which its deadline differs from the current tick, and moves down a level when the wheel
+// reaches its slot. Every level 0 bucket therefore holds entries of exactly one tick, and
+// pop_expired hands them out a whole node at a time. push is O(1); an entry is moved at
+// most once per level, so pop_expired is amortized O(1) per entry, and stretches without
+// timers are skipped through a per-level occupancy mask instead of tick by tick.
+// Emptied nodes are kept for reuse by any bucket, up to the spare node limit.
+template <typename T, size_t NodeMaxSize = 32, typename Allocator = std::allocator<T>>
+class timer_wheel {
+   public:
+    typedef uint64_t tick;
+    typedef timer_entry<T> entry;
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef Allocator allocator_type;
+
+    static constexpr size_t slot_bits = 6;
+    static constexpr size_t slots = size_t(1) << slot_bits;
+    static constexpr size_t levels = (64 + slot_bits - 1) / slot_bits;
+
+    explicit timer_wheel(tick now = 0, const Allocator& al = Allocator());
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+    ~timer_wheel();
+
+    // A deadline before current() is due at the next pop_expired, whatever its `now`.
+    void push(tick deadline, const T& value);
+    void push(tick deadline, T&& value);
+
+    // Hands every entry with deadline <= now to `visit` as std::span<entry>, one node at a
+    // time and in the order of the ticks they fall due at, and moves the wheel to now + 1.
+    // `visit` may push; entries that are due by then are handed out by the same call.
+    // Returns the number of entries.
+    template <typename Visit>
+    size_t pop_expired(tick now, Visit visit);
+
+    inline size_t size() const { return count; }
+    inline bool empty() const { return count == 0; }
+    // the first tick pop_expired has not reached yet
+    inline tick current() const { return cursor; }
+
+    void set_spare_nodes(size_t limit) noexcept;
+    inline size_t spare_nodes() const { return spare_count; }
+
+   private:
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<
+        node<entry, NodeMaxSize>>
+        allocatorNode;
+
+    struct bucket {
+        node<entry, NodeMaxSize>* head = nullptr;
+        node<entry, NodeMaxSize>* tail = nullptr;
+    };
+
+    void place(entry&& item);
+    template <typename Visit>
+    size_t hand_out(bucket& due, Visit& visit);
+    void cascade(size_t level, size_t slot);
+    node<entry, NodeMaxSize>* take_node();
+    void recycle_node(node<entry, NodeMaxSize>*) noexcept;
+    void destroy_node(node<entry, NodeMaxSize>*) noexcept;
+    // the first tick at or after `cursor` whose slot on some level is occupied, or 0 when
+    // the wheel is empty
+    tick next_event() const noexcept;
+
+    static inline size_t digit(tick value, size_t level) {
+        return (value >> (level * slot_bits)) & (slots - 1);
+    }
+
+    allocatorNode alloc;
+    tick cursor;
+    size_t count = 0;
+    bucket wheel[levels][slots];
+    // entries pushed with a deadline the wheel has already passed
+    bucket overdue;
+    // bit s of occupied[L] is set while wheel[L][s] is not empty
+    uint64_t occupied[levels] = {};
+
+    node<entry, NodeMaxSize>* spare = nullptr;
+    size_t spare_count = 0;
+    size_t spare_limit = 16;
+};
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+timer_wheel<T, NodeMaxSize, Allocator>::timer_wheel(tick now, const Allocator& al)
+    : alloc(al), cursor(now) {}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+timer_wheel<T, NodeMaxSize, Allocator>::~timer_wheel() {
+    auto release = [this](bucket& temp) {
+        while (temp.head) {
+            node<entry, NodeMaxSize>* next = temp.head->next;
+            destroy_node(temp.head);
+            temp.head = next;
+        }
+    };
+    for (size_t level = 0; level < levels; ++level) {
+        for (bucket& temp : wheel[level]) {
+            release(temp);
+        }
+    }
+    release(overdue);
+    set_spare_nodes(0);
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void timer_wheel<T, NodeMaxSize, Allocator>::push(tick deadline, const T& value) {
+    place(entry{deadline, value});
+    ++count;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void timer_wheel<T, NodeMaxSize, Allocator>::push(tick deadline, T&& value) {
+    place(entry{deadline, std::move(value)});
+    ++count;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void timer_wheel<T, NodeMaxSize, Allocator>::place(entry&& item) {
+    tick diff = item.deadline ^ cursor;
+    size_t level = diff ? (std::bit_width(diff) - 1) / slot_bits : 0;
+    size_t slot = digit(item.deadline, level);
+    bucket& target = item.deadline < cursor ? overdue : wheel[level][slot];
+    if (!target.tail || target.tail->end == NodeMaxSize) {
+        node<entry, NodeMaxSize>* bufer = take_node();
+        if (target.tail) {
+            target.tail->link_forward(bufer);
+        } else {
+            target.head = bufer;
+            if (&target != &overdue) {
+                occupied[level] |= uint64_t(1) << slot;
+            }
+        }
+        target.tail = bufer;
+    }
+    std::construct_at(target.tail->arr() + target.tail->end, std::move(item));
+    ++target.tail->end;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+template <typename Visit>
+size_t timer_wheel<T, NodeMaxSize, Allocator>::pop_expired(tick now, Visit visit) {
+    size_t handed = hand_out(overdue, visit);
+    while (count > 0) {
+        tick event = next_event();
+        if (event > now) {
+            break;
+        }
+        cursor = event;
+        // entries of higher levels whose slot starts here move down; none of them can land
+        // in a slot cascaded by the same loop, so the order of the levels does not matter
+        for (size_t level = 1;
+             level < levels && (cursor & ((tick(1) << (level * slot_bits)) - 1)) == 0; ++level) {
+            if (occupied[level] & (uint64_t(1) << digit(cursor, level))) {
+                cascade(level, digit(cursor, level));
+            }
+        }
+        size_t slot = digit(cursor, 0);
+        do {
+            handed += hand_out(wheel[0][slot], visit);
+            // whatever `visit` pushed for earlier ticks
+            handed += hand_out(overdue, visit);
+        } while (wheel[0][slot].head);
+        occupied[0] &= ~(uint64_t(1) << slot);
+        if (cursor == now) {
+            break;
+        }
+        ++cursor;
+    }
+    if (cursor <= now) {
+        cursor = now + 1;
+    }
+    return handed;
+}
+
+// Empties a bucket into `visit` node by node; entries pushed to it meanwhile are included.
+template <typename T, size_t NodeMaxSize, typename Allocator>
+template <typename Visit>
+size_t timer_wheel<T, NodeMaxSize, Allocator>::hand_out(bucket& due, Visit& visit) {
+    size_t handed = 0;
+    while (due.head) {
+        node<entry, NodeMaxSize>* temp = due.head;
+        due.head = temp->next;
+        if (!due.head) {
+            due.tail = nullptr;
+        }
+        temp->next = nullptr;
+        count -= temp->end;
+        handed += temp->end;
+        try {
+            visit(std::span<entry>(temp->arr(), temp->end));
+        } catch (...) {
+            recycle_node(temp);
+            throw;
+        }
+        recycle_node(temp);
+    }
+    return handed;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void timer_wheel<T, NodeMaxSize, Allocator>::cascade(size_t level, size_t slot) {
+    bucket& source = wheel[level][slot];
+    node<entry, NodeMaxSize>* temp = source.head;
+    source.head = nullptr;
+    source.tail = nullptr;
+    occupied[level] &= ~(uint64_t(1) << slot);
+    while (temp) {
+        node<entry, NodeMaxSize>* next = temp->next;
+        size_t moved = 0;
+        try {
+            for (; moved < temp->end; ++moved) {
+                place(std::move(temp->arr()[moved]));
+            }
+        } catch (...) {
+            // what was not moved yet goes back to the slot, so no entry is lost
+            std::move(temp->arr() + moved, temp->arr() + temp->end, temp->arr());
+            std::destroy(temp->arr() + temp->end - moved, temp->arr() + temp->end);
+            temp->end -= moved;
+            source.head = temp;
+            for (source.tail = temp; source.tail->next; source.tail = source.tail->next) {
+            }
+            occupied[level] |= uint64_t(1) << slot;
+            throw;
+        }
+        temp->next = nullptr;
+        recycle_node(temp);
+        temp = next;
+    }
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+typename timer_wheel<T, NodeMaxSize, Allocator>::tick
+timer_wheel<T, NodeMaxSize, Allocator>::next_event() const noexcept {
+    tick best = 0;
+    bool found = false;
+    for (size_t level = 0; level < levels; ++level) {
+        uint64_t ahead = occupied[level] & (~uint64_t(0) << digit(cursor, level));
+        if (!ahead) {
+            continue;
+        }
+        size_t shift = level * slot_bits;
+        size_t slot = std::countr_zero(ahead);
+        tick block = 0;
+        if (shift + slot_bits < 64) {
+            block = cursor >> (shift + slot_bits) << (shift + slot_bits);
+        }
+        tick event = block | (tick(slot) << shift);
+        // the slot the cursor is in is due right away
+        if (event < cursor) {
+            event = cursor;
+        }
+        if (!found || event < best) {
+            best = event;
+            found = true;
+        }
+    }
+    return best;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator>
+node<timer_entry<T>, NodeMaxSize>* timer_wheel<T, NodeMaxSize, Allocator>::take_node() {
+    if (spare) {
+        node<entry, NodeMaxSize>* bufer = spare;
+        spare = bufer->next;
+        bufer->next = nullptr;
+        --spare_count;
+        return bufer;
+    }
+    node<entry, NodeMaxSize>* bufer = alloc.allocate(1);
+    try {
+        std::allocator_traits<allocatorNode>::construct(alloc, bufer);
+    } catch (...) {
+        alloc.deallocate(bufer, 1);
+        throw;
+    }
+    return bufer;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void timer_wheel<T, NodeMaxSize, Allocator>::recycle_node(
+    node<entry, NodeMaxSize>* target) noexcept {
+    if (spare_count >= spare_limit) {
+        destroy_node(target);
+        return;
+    }
+    std::destroy(target->arr(), target->arr() + target->end);
+    target->end = 0;
+    target->prev = nullptr;
+    target->next = spare;
+    spare = target;
+    ++spare_count;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void timer_wheel<T, NodeMaxSize, Allocator>::destroy_node(
+    node<entry, NodeMaxSize>* target) noexcept {
+    std::allocator_traits<allocatorNode>::destroy(alloc, target);
+    alloc.deallocate(target, 1);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator>
+void timer_wheel<T, NodeMaxSize, Allocator>::set_spare_nodes(size_t limit) noexcept {
+    spare_limit = limit;
+    while (spare_count > limit) {
+        node<entry, NodeMaxSize>* temp = spare;
+        spare = temp->next;
+        --spare_count;
+        destroy_node(temp);
+    }
+}
@@ -1,10 +1,40 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <initializer_list>
+#include <limits>
 #include <list>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <thread>
 
 #include "my_iterator.h"
+#include "unrolled_list_trace.h"
 
-template <typename T, size_t NodeMaxSize = 10, typename Allocator = std::allocator<T>>
+// How a parallel bulk build splits its work: `threads` workers (0 means one per hardware
+// thread) claim and steal runs of `grain` nodes.
+struct parallel_policy {
+    size_t threads = 0;
+    size_t grain = 16;
+};
+
+// Instrumentation is told about every push, pop, insert, erase, node split and node
+// allocation through a scope object (see unrolled_list_trace.h); the default policy
+// records nothing.
+template <typename T, size_t NodeMaxSize = 10, typename Allocator = std::allocator<T>,
+          typename Instrumentation = no_instrumentation>
 class unrolled_list {
+    friend struct unrolled_list_io;
+    friend struct std::hash<unrolled_list>;
+    template <typename, size_t, typename, typename>
+    friend class unrolled_list;
+
    public:
     typedef T value_type;
     typedef T& reference;
@@ -19,53 +49,116 @@ class unrolled_list {
 
     typedef typename std::allocator_traits<Allocator>::template rebind_alloc<node<T, NodeMaxSize>>
         allocatorNode;
+    typedef
+        typename std::allocator_traits<Allocator>::template rebind_alloc<node_slab<T, NodeMaxSize>>
+            allocatorSlab;
 
-    unrolled_list();
+    constexpr unrolled_list();
     unrolled_list(const T&, Allocator&);
     unrolled_list(const T&, const size_t&, Allocator&);
     unrolled_list(const size_t&, const T&);
     unrolled_list(iterator&, iterator&);
     unrolled_list(iterator&, iterator&, Allocator&);
     unrolled_list(std::list<T>::iterator begin, std::list<T>::iterator end, const Allocator& al);
-    unrolled_list(const std::initializer_list<T>&);
-    unrolled_list(const Allocator&);
+    constexpr unrolled_list(const std::initializer_list<T>&);
+    constexpr unrolled_list(const Allocator&);
+    constexpr unrolled_list(unrolled_list&&);
     unrolled_list(unrolled_list&&, const Allocator&);
-    unrolled_list(const unrolled_list&);
+    constexpr unrolled_list(const unrolled_list&);
+    constexpr unrolled_list(const unrolled_list&, const Allocator&);
+
+    constexpr ~unrolled_list();
 
-    ~unrolled_list();
+    unrolled_list& operator=(const unrolled_list&);
+    unrolled_list& operator=(unrolled_list&&);
 
-    unrolled_list& operator=(const unrolled_list<T, NodeMaxSize, Allocator>&);
+    // Non-const accessors close the gap of an open insert_cursor; const ones only read.
+    inline constexpr iterator begin() {
+        seal_gap();
+        return iterator(head, 0);
+    }
+    inline constexpr iterator end() {
+        seal_gap();
+        return iterator(tail, tail->end);
+    }
+    inline constexpr const_iterator begin() const { return const_iterator(head, 0); }
+    inline constexpr const_iterator end() const { return const_iterator(tail, tail->end); }
+    inline constexpr const_iterator cbegin() const { return begin(); }
+    inline constexpr const_iterator cend() const { return end(); }
+    inline constexpr reverse_iterator rbegin() {
+        seal_gap();
+        return reverse_iterator(tail, tail->end);
+    }
+    inline constexpr reverse_iterator rend() {
+        seal_gap();
+        return reverse_iterator(head, 0);
+    }
+    inline constexpr const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(tail, tail->end);
+    }
+    inline constexpr const_reverse_iterator rend() const { return const_reverse_iterator(head, 0); }
+    inline constexpr const_reverse_iterator crbegin() const { return rbegin(); }
+    inline constexpr const_reverse_iterator crend() const { return rend(); }
 
-    inline iterator begin() { return iterator(head, 0); }
-    inline iterator end() { return iterator(tail, tail->end); }
-    inline const_iterator begin() const { return const_iterator(head, 0); }
-    inline const_iterator end() const { return const_iterator(tail, tail->end); }
-    inline const_iterator cbegin() const { return const_iterator(head, 0); }
-    inline const_iterator cend() const { return const_iterator(tail, tail->end); }
-    inline reverse_iterator rbegin() { return reverse_iterator(tail, tail->end - 1); }
-    inline reverse_iterator rend() { return reverse_iterator(head, -1); }
-    inline const_reverse_iterator rbegin() const {
-        return const_reverse_iterator(tail, tail->end - 1);
+    // nodes() walks the node chain, segments() yields the live elements of each node as
+    // a span, so bulk consumers can work on contiguous runs instead of single elements.
+    inline constexpr auto nodes() {
+        seal_gap();
+        return std::ranges::subrange(node_iterator<node<T, NodeMaxSize>>(head),
+                                     std::default_sentinel);
+    }
+    inline constexpr auto nodes() const {
+        return std::ranges::subrange(node_iterator<const node<T, NodeMaxSize>>(head),
+                                     std::default_sentinel);
+    }
+    inline constexpr auto segments() {
+        return nodes() | std::views::transform([](node<T, NodeMaxSize>& temp) {
+                   return std::span<T>(&temp.at(0), temp.end);
+               });
     }
-    inline const_reverse_iterator rend() const { return const_reverse_iterator(head, -1); }
-    inline const_reverse_iterator crbegin() const {
-        return const_reverse_iterator(tail, tail->end - 1);
+    inline constexpr auto segments() const {
+        return nodes() | std::views::transform([](const node<T, NodeMaxSize>& temp) {
+                   return std::span<const T>(&temp.at(0), temp.end);
+               });
     }
-    inline const_reverse_iterator crend() const { return const_reverse_iterator(head, -1); }
 
-    inline bool operator==(const unrolled_list<T, NodeMaxSize, Allocator>& rhs) const {
-        return std::equal(this->cbegin(), this->cend(), rhs.cbegin(), rhs.cend());
+    // Positions of elements. Every node remembers its ordinal and how many elements are
+    // in front of it; pushes and pops at either end keep that current, any other edit
+    // drops it. refresh_positions() renumbers the chain in one pass, and the non-const
+    // queries call it first. The const ones never write to the nodes, so they are safe to
+    // run concurrently: they answer in O(1) while positions are current and walk the
+    // nodes in front of the iterator otherwise. Iterators into nodes numbered in the same
+    // pass also compare (<, <=>) by ordinal without walking.
+    constexpr void refresh_positions() noexcept;
+    constexpr size_t index_of(const_iterator it);
+    constexpr size_t index_of(const_iterator it) const;
+    constexpr std::ptrdiff_t distance(const_iterator first, const_iterator last);
+    constexpr std::ptrdiff_t distance(const_iterator first, const_iterator last) const;
+    inline constexpr auto subrange(iterator first, iterator last) {
+        return std::ranges::subrange<iterator, iterator, std::ranges::subrange_kind::sized>(
+            first, last, distance(first, last));
     }
-    inline bool operator!=(const unrolled_list<T, NodeMaxSize, Allocator>& rhs) const {
-        return !(this == rhs);
+    inline constexpr auto subrange(const_iterator first, const_iterator last) const {
+        return std::ranges::subrange<const_iterator, const_iterator,
+                                     std::ranges::subrange_kind::sized>(
+            first, last, distance(first, last));
     }
 
-    void swap(const unrolled_list<T, NodeMaxSize, Allocator>&);
-    inline size_t size() { return capacity; }
-    inline size_t max_size() { return NodeMaxSize * node_capacity; }
-    inline bool is_empty() { return *this == unrolled_list<T, NodeMaxSize, Allocator>(); }
-    inline bool empty() { return *this == unrolled_list<T, NodeMaxSize, Allocator>(); }
-    inline allocator_type get_allocator() const { return alloc; }
+    // Both compare node payloads pairwise in runs as long as the shorter of the two
+    // current segments; equality of integral, enum and pointer types goes through memcmp.
+    constexpr bool operator==(const unrolled_list& rhs) const;
+    constexpr auto operator<=>(const unrolled_list& rhs) const
+        requires std::three_way_comparable<T>;
+
+    constexpr void swap(unrolled_list&);
+    friend inline constexpr void swap(unrolled_list& lhs, unrolled_list& rhs) {
+        lhs.swap(rhs);
+    }
+    inline constexpr size_t size() const { return capacity; }
+    inline constexpr size_t max_size() const { return NodeMaxSize * node_capacity; }
+    inline constexpr bool is_empty() const { return capacity == 0; }
+    inline constexpr bool empty() const { return capacity == 0; }
+    inline constexpr allocator_type get_allocator() const { return alloc; }
 
     iterator insert(iterator it, T value);
     iterator insert(iterator it, size_t n, T value);
@@ -81,19 +174,111 @@ class unrolled_list {
     iterator erase(const_iterator point) noexcept;
     iterator erase(const_iterator begin, const_iterator end) noexcept;
 
-    void clear() noexcept;
+    // Destroys every element. Emptied nodes go to the spare cache, which may grow to
+    // `retain_nodes` for this call, so refilling to the same size allocates nothing;
+    // trim releases cached nodes beyond `max_nodes`.
+    inline constexpr void clear() noexcept { clear(spare_limit); }
+    constexpr void clear(size_t retain_nodes) noexcept;
+    void trim(size_t max_nodes) noexcept;
     void assign(const_iterator, const_iterator) noexcept;
     void assign(std::initializer_list<T>) noexcept;
     void assign(size_t, T) noexcept;
 
-    void push_back(const T&);
-    void push_front(const T&);
-    void pop_back() noexcept;
-    void pop_front() noexcept;
-    inline T& front() { return head->front(); }
-    inline T& back() { return tail->back(); }
-    inline const T& front() const { return head->front(); }
-    inline const T& back() const { return tail->back(); }
+    constexpr void push_back(const T&);
+    // Tops up the tail, then fills each fresh node completely before linking it, so a
+    // lazy view can be materialised without an intermediate buffer.
+    template <std::ranges::input_range Range>
+    void append_range(Range&& range);
+    // Bulk builds on several threads. All nodes come from one slab allocated up front;
+    // each worker fills whole nodes of the runs it claims or steals and links them, and
+    // the runs are stitched in order once every worker is done. from_parallel stores
+    // gen(i) at position i, transform_to stores func(x) for every element x in order;
+    // both callables are invoked concurrently.
+    template <typename Gen>
+    static unrolled_list from_parallel(size_t n, Gen gen, parallel_policy policy = {},
+                                       const Allocator& al = Allocator());
+    template <typename Func>
+    auto transform_to(Func func, parallel_policy policy = {}) const;
+    constexpr void push_front(const T&);
+    constexpr void pop_back() noexcept;
+    constexpr void pop_front() noexcept;
+    // Drop up to `count` elements from one end. Whole nodes are unlinked in one step
+    // each, only the boundary node is trimmed element-wise.
+    constexpr void pop_front_n(size_t count) noexcept;
+    constexpr void pop_back_n(size_t count) noexcept;
+    inline constexpr T& front() {
+        seal_gap();
+        return head->front();
+    }
+    inline constexpr T& back() {
+        seal_gap();
+        return tail->back();
+    }
+    inline constexpr const T& front() const { return head->front(); }
+    inline constexpr const T& back() const { return tail->back(); }
+
+    // Runs of inserts at one position, as an editor types in front of its cursor. The
+    // first insert into the middle of a node moves the elements behind it to the far end
+    // of the node once, and the following ones fill the free slots in O(1). The gap is
+    // closed by close() or when the cursor goes away, and by any non-const use of the
+    // list, so no iterator ever sees it. While a gap is open, const observers other than
+    // size() and broken_invariant() must not be called; edits other than through the
+    // cursor invalidate it like an iterator.
+    class gap_cursor {
+       public:
+        inline gap_cursor(gap_cursor&& other) noexcept
+            : list(std::exchange(other.list, nullptr)), target(other.target),
+              index(other.index) {}
+        gap_cursor(const gap_cursor&) = delete;
+        gap_cursor& operator=(const gap_cursor&) = delete;
+        gap_cursor& operator=(gap_cursor&&) = delete;
+        inline ~gap_cursor() {
+            if (list) {
+                list->seal_gap();
+            }
+        }
+
+        // Inserts in front of the cursor, which stays right after the new element.
+        inline void insert(T value) { list->gap_insert(target, index, std::move(value)); }
+        // Closes the gap and ends the run; returns the element the cursor stood before.
+        inline iterator close() {
+            std::exchange(list, nullptr)->seal_gap();
+            if (index == target->end && target->next) {
+                return iterator(target->next, 0);
+            }
+            return iterator(target, index);
+        }
+
+       private:
+        friend class unrolled_list;
+        inline gap_cursor(unrolled_list* list, node<T, NodeMaxSize>* target, size_t index)
+            : list(list), target(target), index(index) {}
+
+        unrolled_list* list;
+        node<T, NodeMaxSize>* target;
+        size_t index;
+    };
+    inline gap_cursor insert_cursor(const_iterator pos) {
+        return gap_cursor(this, const_cast<node<T, NodeMaxSize>*>(pos.ptr), pos.index());
+    }
+
+    // Rebuilds the node chain in list order out of one contiguous slab with every node
+    // but the last one full. defragment_step relocates at most `budget` old nodes per call
+    // and returns true once the whole chain has been rebuilt.
+    void defragment();
+    bool defragment_step(size_t budget);
+
+    // Nodes emptied at either end are kept, up to `limit` of them (two by default), and reused
+    // when either end needs a new node, so a list used as a queue stops allocating once it
+    // reaches its working size. reserve_nodes fills the cache up front.
+    void set_spare_nodes(size_t limit) noexcept;
+    void reserve_nodes(size_t);
+    inline constexpr size_t spare_nodes() const { return spare_count; }
+
+    // Walks the whole list and names the first broken structural invariant, or returns
+    // nullptr: link symmetry, fill bounds, the element and node counters, the spare cache,
+    // an open gap and, while they are current, node positions. For tests and fuzzing.
+    constexpr const char* broken_invariant() const noexcept;
 
    private:
     node<T, NodeMaxSize>* head;
@@ -102,27 +287,82 @@ class unrolled_list {
     allocatorNode alloc;
     size_t capacity;
     size_t node_capacity;
+
+    node_slab<T, NodeMaxSize>* defrag_slab = nullptr;
+    node<T, NodeMaxSize>* defrag_source = nullptr;
+    node<T, NodeMaxSize>* defrag_out = nullptr;
+    // elements relocated by the current defragment pass
+    size_t defrag_moved = 0;
+
+    node<T, NodeMaxSize>* spare = nullptr;
+    size_t spare_count = 0;
+    size_t spare_limit = 2;
+
+    // Positions are current while the head carries the current `epoch`: only renumber()
+    // hands it out, and nodes linked at either end copy it from their neighbour. Stored
+    // prefixes are offset by `bias`, so a push or pop at the front shifts all of them.
+    size_t epoch = 1;
+    size_t bias = 0;
+
+    // the node that may hold an open insert gap
+    node<T, NodeMaxSize>* gapped = nullptr;
+
+    // Scalars without padding bits or several encodings of one value compare equal exactly
+    // when their bytes do; class types may define operator== and std::hash of their own.
+    static constexpr bool bytewise_comparable =
+        std::is_scalar_v<T> && std::has_unique_object_representations_v<T>;
+
+    constexpr void swap_contents(unrolled_list&) noexcept;
+    constexpr void destroy_node(node<T, NodeMaxSize>*) noexcept;
+    node<T, NodeMaxSize>* take_slab_node();
+    constexpr void release_slab(node_slab<T, NodeMaxSize>*) noexcept;
+    constexpr void finish_defragment() noexcept;
+    constexpr node<T, NodeMaxSize>* create_node();
+    constexpr node<T, NodeMaxSize>* start_node(const T&);
+    constexpr void recycle_node(node<T, NodeMaxSize>*) noexcept;
+    constexpr void release_spares(size_t) noexcept;
+    constexpr void unlink_node(node<T, NodeMaxSize>*) noexcept;
+    constexpr void erase_slots(node<T, NodeMaxSize>*, size_t, size_t) noexcept;
+    inline constexpr void forget_positions() noexcept { ++epoch; }
+    inline constexpr void seal_gap() {
+        if (gapped) {
+            gapped->close_gap();
+            gapped = nullptr;
+        }
+    }
+    constexpr void make_room(node<T, NodeMaxSize>*& target, size_t& index);
+    constexpr void gap_insert(node<T, NodeMaxSize>*& target, size_t& index, T value);
+    constexpr void renumber() noexcept;
+    constexpr size_t prefix_of(const node<T, NodeMaxSize>*) const noexcept;
+    constexpr void number_tail() noexcept;
+    constexpr void number_head() noexcept;
+    template <typename Visit>
+    constexpr bool visit_segments(const unrolled_list&, Visit) const;
+    template <typename Fill>
+    static unrolled_list build_parallel(size_t n, parallel_policy policy, const Allocator& al,
+                                        Fill fill);
 };
 
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list() : alloc() {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list() : alloc() {
     capacity = 0;
     node_capacity = 1;
     head = alloc.allocate(1);
     std::allocator_traits<allocatorNode>::construct(alloc, head);
     tail = head;
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(const T& value, Allocator& al) : alloc(al) {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    const T& value, Allocator& al) : alloc(al) {
     capacity = 1;
     node_capacity = 1;
     head = alloc.allocate(1);
     std::allocator_traits<allocatorNode>::construct(alloc, head, value);
     tail = head;
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(const T& value, const size_t& n,
-                                                        Allocator& al)
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    const T& value, const size_t& n, Allocator& al)
     : alloc(al) {
     capacity = n;
     node_capacity = 1;
@@ -134,8 +374,9 @@ unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(const T& value, const si
         ++node_capacity;
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(const size_t& n, const T& value) : alloc() {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    const size_t& n, const T& value) : alloc() {
     capacity = n;
     node_capacity = 1;
 
@@ -164,8 +405,9 @@ unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(const size_t& n, const T
         len -= NodeMaxSize / 2;
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(iterator& begin, iterator& end) : alloc() {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    iterator& begin, iterator& end) : alloc() {
     capacity = 0;
     node_capacity = 1;
     head = alloc.allocate(1);
@@ -181,9 +423,9 @@ unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(iterator& begin, iterato
         ++begin;
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(iterator& begin, iterator& end,
-                                                        Allocator& al)
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    iterator& begin, iterator& end, Allocator& al)
     : alloc(al) {
     capacity = 0;
     node_capacity = 1;
@@ -194,9 +436,9 @@ unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(iterator& begin, iterato
         try {
             tail->push_back(*begin);
             ++capacity;
-        } catch (std::runtime_error) {
+        } catch (...) {
             this->~unrolled_list();
-            throw std::runtime_error("");
+            throw;
         }
         if (tail->next) {
             tail = tail->next;
@@ -205,10 +447,9 @@ unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(iterator& begin, iterato
         ++begin;
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(std::list<T>::iterator begin,
-                                                        std::list<T>::iterator end,
-                                                        const Allocator& al)
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    std::list<T>::iterator begin, std::list<T>::iterator end, const Allocator& al)
     : alloc(al) {
     capacity = 0;
     node_capacity = 1;
@@ -226,164 +467,275 @@ unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(std::list<T>::iterator b
             tail = temp;
         }
         try {
-            std::construct_at(tail->arr + tail->end, *begin);
-        } catch (std::runtime_error) {
+            std::construct_at(tail->arr() + tail->end, *begin);
+        } catch (...) {
             this->~unrolled_list();
-            throw std::runtime_error("");
+            throw;
         }
         ++tail->end;
         ++begin;
         ++capacity;
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(const std::initializer_list<T>& il)
-    : alloc() {
-    capacity = 0;
-    node_capacity = 1;
-    head = alloc.allocate(1);
-    std::allocator_traits<allocatorNode>::construct(alloc, head);
-    tail = head;
-    iterator begin = il.begin();
-    iterator end = il.end();
-    while (begin != end) {
-        tail->push_back(*begin);
-        ++capacity;
-        if (tail->next) {
-            tail = tail->next;
-            ++node_capacity;
-        }
-        ++begin;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    const std::initializer_list<T>& il)
+    : unrolled_list() {
+    for (const T& value : il) {
+        push_back(value);
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(const Allocator& al) : alloc(al) {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    const Allocator& al) : alloc(al) {
     capacity = 0;
     node_capacity = 1;
     head = alloc.allocate(1);
     std::allocator_traits<allocatorNode>::construct(alloc, head);
     tail = head;
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(unrolled_list&& other, const Allocator& al)
-    : alloc(al) {
-    capacity = 0;
-    node_capacity = 1;
-    head = alloc.allocate(1);
-    std::allocator_traits<allocatorNode>::construct(alloc, head);
-    tail = head;
-    iterator begin = other.begin();
-    iterator end = other.end();
-    while (begin != end) {
-        tail->push_back(*begin);
-        ++capacity;
-        if (tail->next) {
-            tail = tail->next;
-            ++node_capacity;
-        }
-        ++begin;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    unrolled_list&& other)
+    : unrolled_list(Allocator(other.alloc)) {
+    swap_contents(other);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    unrolled_list&& other, const Allocator& al)
+    : unrolled_list(al) {
+    if (alloc == other.alloc) {
+        swap_contents(other);
+        return;
+    }
+    for (const T& value : other) {
+        push_back(value);
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::unrolled_list(const unrolled_list& other) : alloc() {
-    capacity = other.capacity;
-    node_capacity = other.node_capacity;
-    head = alloc.allocate(1);
-    std::allocator_traits<allocatorNode>::construct(alloc, head);
-    tail = head;
-    iterator begin = other.begin();
-    iterator end = other.end();
-    while (begin != end) {
-        tail->push_back(*begin);
-        if (tail->next) {
-            tail = tail->next;
-        }
-        ++begin;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    const unrolled_list& other)
+    : unrolled_list(other, Allocator(std::allocator_traits<allocatorNode>::
+                                         select_on_container_copy_construction(other.alloc))) {}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unrolled_list(
+    const unrolled_list& other, const Allocator& al)
+    : unrolled_list(al) {
+    for (const T& value : other) {
+        push_back(value);
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>::~unrolled_list() {
-    node<T, NodeMaxSize>* temp = tail->prev;
-    while (temp != head && temp) {
-        std::allocator_traits<allocatorNode>::destroy(alloc, tail);
-        alloc.deallocate(tail, 1);
-        tail = temp;
-        temp = temp->prev;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::~unrolled_list() {
+    seal_gap();
+    while (head) {
+        node<T, NodeMaxSize>* temp = head->next;
+        destroy_node(head);
+        head = temp;
     }
-    std::allocator_traits<allocatorNode>::destroy(alloc, head);
-    alloc.deallocate(head, 1);
-    head = nullptr;
+    release_spares(0);
+    finish_defragment();
     tail = nullptr;
 }
 
-template <typename T, size_t NodeMaxSize, typename Allocator>
-unrolled_list<T, NodeMaxSize, Allocator>& unrolled_list<T, NodeMaxSize, Allocator>::operator=(
-    const unrolled_list<T, NodeMaxSize, Allocator>& other) {
-    if (this != &other) {
-        this = other;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>&
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::operator=(
+    const unrolled_list& other) {
+    if (this == &other) {
+        return *this;
+    }
+    if constexpr (std::allocator_traits<allocatorNode>::propagate_on_container_copy_assignment::value) {
+        unrolled_list temp(other, Allocator(other.alloc));
+        swap_contents(temp);
+        std::swap(alloc, temp.alloc);
+    } else {
+        unrolled_list temp(other, Allocator(alloc));
+        swap_contents(temp);
     }
-    return this;
+    return *this;
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::swap(
-    const unrolled_list<T, NodeMaxSize, Allocator>& other) {
-    std::swap(this->head, other->head);
-    std::swap(this->tail, other->tail);
-    if (std::allocator_traits<Allocator>::propagate_on_container_swap) {
-        swap(this->alloc, other->alloc);
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>&
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::operator=(
+    unrolled_list&& other) {
+    if (this == &other) {
+        return *this;
     }
+    if constexpr (std::allocator_traits<allocatorNode>::propagate_on_container_move_assignment::value) {
+        unrolled_list temp(std::move(other));
+        swap_contents(temp);
+        std::swap(alloc, temp.alloc);
+    } else {
+        unrolled_list temp(std::move(other), Allocator(alloc));
+        swap_contents(temp);
+    }
+    return *this;
 }
-
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
-    my_iterator<T, NodeMaxSize> it, T value) {
-    if (it.ptr->end == NodeMaxSize) {
-        ++node_capacity;
-        node<T, NodeMaxSize>* bufer = alloc.allocate(1);
-        std::allocator_traits<allocatorNode>::construct(alloc, bufer);
-        it.ptr->thread_forward(bufer);
-        while (tail->next) {
-            tail = tail->next;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+template <typename Visit>
+constexpr bool unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::visit_segments(
+    const unrolled_list& rhs, Visit visit) const {
+    const node<T, NodeMaxSize>* left = head;
+    const node<T, NodeMaxSize>* right = rhs.head;
+    size_t left_pos = 0;
+    size_t right_pos = 0;
+    while (left && right) {
+        if (left_pos == left->end) {
+            left = left->next;
+            left_pos = 0;
+            continue;
+        }
+        if (right_pos == right->end) {
+            right = right->next;
+            right_pos = 0;
+            continue;
         }
-        if (it.current > it.ptr->end) {
-            it.ptr = it.ptr->next;
-            it.current -= NodeMaxSize / 2 + 1;
+        size_t len = std::min(left->end - left_pos, right->end - right_pos);
+        if (!visit(left->arr() + left_pos, right->arr() + right_pos, len)) {
+            return false;
         }
+        left_pos += len;
+        right_pos += len;
     }
-    std::reverse(it.ptr->arr + it.current, it.ptr->arr + it.ptr->end);
-    std::reverse(it.ptr->arr + it.current, it.ptr->arr + it.ptr->end + 1);
-    try {
-        if constexpr (std::is_assignable_v<T, T>) {
-            it.ptr->arr[it.current] = value;
-        } else {
-            std::construct_at(it.ptr->arr + it.current, value);
+    return true;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr bool unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::operator==(
+    const unrolled_list& rhs) const {
+    if (capacity != rhs.capacity) {
+        return false;
+    }
+    return visit_segments(rhs, [](const T* left, const T* right, size_t len) {
+        if constexpr (bytewise_comparable) {
+            if !consteval {
+                return std::memcmp(left, right, len * sizeof(T)) == 0;
+            }
         }
-    } catch (...) {
-        std::reverse(it.ptr->arr + it.current, it.ptr->arr + it.ptr->end + 1);
-        std::reverse(it.ptr->arr + it.current, it.ptr->arr + it.ptr->end);
-        throw std::runtime_error("Failure at insert");
+        return std::equal(left, left + len, right);
+    });
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr auto unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::operator<=>(
+    const unrolled_list& rhs) const
+    requires std::three_way_comparable<T>
+{
+    std::compare_three_way_result_t<T> res = std::strong_ordering::equal;
+    visit_segments(rhs, [&res](const T* left, const T* right, size_t len) {
+        res = std::lexicographical_compare_three_way(left, left + len, right, right + len);
+        return res == 0;
+    });
+    if (res != 0) {
+        return res;
     }
-    ++it.ptr->end;
+    return std::compare_three_way_result_t<T>(capacity <=> rhs.capacity);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::swap(
+    unrolled_list& other) {
+    swap_contents(other);
+    if constexpr (std::allocator_traits<allocatorNode>::propagate_on_container_swap::value) {
+        std::swap(alloc, other.alloc);
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::swap_contents(
+    unrolled_list& other) noexcept {
+    finish_defragment();
+    other.finish_defragment();
+    std::swap(head, other.head);
+    std::swap(tail, other.tail);
+    std::swap(capacity, other.capacity);
+    std::swap(node_capacity, other.node_capacity);
+    std::swap(spare, other.spare);
+    std::swap(spare_count, other.spare_count);
+    std::swap(epoch, other.epoch);
+    std::swap(bias, other.bias);
+    std::swap(gapped, other.gapped);
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::insert(
+    my_iterator<T, NodeMaxSize> it, T value) {
+    typename Instrumentation::scope timer(list_op::insert);
+    node<T, NodeMaxSize>* target = it.ptr;
+    size_t index = it.index();
+    forget_positions();
+    seal_gap();
+    make_room(target, index);
+    T* slot = target->arr() + index;
+    T* last = target->arr() + target->end;
+    if (slot == last) {
+        std::construct_at(last, std::move(value));
+    } else {
+        std::construct_at(last, std::move(last[-1]));
+        std::move_backward(slot, last - 1, last);
+        *slot = std::move(value);
+    }
+    ++target->end;
     ++capacity;
-    return it;
+    return iterator(target, index);
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
+// splits a full target so that slot `index` of it, or of its new successor, is free
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::make_room(
+    node<T, NodeMaxSize>*& target, size_t& index) {
+    if (target->end != NodeMaxSize) {
+        return;
+    }
+    node<T, NodeMaxSize>* bufer = create_node();
+    ++node_capacity;
+    {
+        typename Instrumentation::scope split(list_op::split);
+        target->thread_forward(bufer);
+    }
+    if (tail == target) {
+        tail = bufer;
+    }
+    if (index > target->end) {
+        index -= target->end;
+        target = bufer;
+    }
+}
+// Inserts in front of slot `index` and moves the cursor past the new element. The
+// first insert into the middle of a node opens a gap there, the following ones at the
+// cursor fill it.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::gap_insert(
+    node<T, NodeMaxSize>*& target, size_t& index, T value) {
+    typename Instrumentation::scope timer(list_op::insert);
+    forget_positions();
+    if (gapped != target || target->gap_size == 0 || target->gap_at != index) {
+        seal_gap();
+        make_room(target, index);
+        if (index < target->end) {
+            target->open_gap(index);
+            gapped = target;
+        }
+    }
+    std::construct_at(target->arr() + index, std::move(value));
+    if (gapped == target) {
+        ++target->gap_at;
+        --target->gap_size;
+    }
+    ++target->end;
+    ++capacity;
+    ++index;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::insert(
     my_iterator<T, NodeMaxSize> it, size_t n, T value) {
+    seal_gap();
     node<T, NodeMaxSize>* bufer = alloc.allocate(1);
-    for (size_t i = 0; i < it.ptr->end - it.current - 1; ++i) {
-        try {
-            if constexpr (std::is_assignable_v<T, T>) {
-                bufer->arr[i] = it.ptr->arr[it.current + i + 1];
-            } else {
-                std::construct_at(bufer->arr + it.current + i + 1, *((i + 1) + it));
-            }
-        } catch (...) {
-            throw std::runtime_error("Failure at insert");
+    for (size_t i = 0; i < it.ptr->end - it.index() - 1; ++i) {
+        if constexpr (std::is_assignable_v<T, T>) {
+            bufer->arr()[i] = it.ptr->arr()[it.index() + i + 1];
+        } else {
+            std::construct_at(bufer->arr() + it.index() + i + 1, *((i + 1) + it));
         }
     }
-    bufer->end = it.ptr->end - it.current - 1;
-    end = it.current + 1;
+    bufer->end = it.ptr->end - it.index() - 1;
+    end = it.index() + 1;
     node_capacity += 2;
     bufer->link_forward(it->ptr->next);
 
@@ -393,17 +745,9 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
     size_t len = n;
 
     if (len > NodeMaxSize / 2) {
-        try {
-            std::allocator_traits<allocatorNode>::construct(alloc, forward, NodeMaxSize / 2, value);
-        } catch (...) {
-            throw std::runtime_error("Failure at constructing node while inserting");
-        }
+        std::allocator_traits<allocatorNode>::construct(alloc, forward, NodeMaxSize / 2, value);
     } else {
-        try {
-            std::allocator_traits<allocatorNode>::construct(alloc, forward, len, value);
-        } catch (...) {
-            throw std::runtime_error("Failure at constucting node while inserting");
-        }
+        std::allocator_traits<allocatorNode>::construct(alloc, forward, len, value);
     }
     len -= NodeMaxSize / 2;
 
@@ -411,18 +755,10 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
         node<T, NodeMaxSize>* back = forward;
         forward = alloc.allocate(1);
         if (len > NodeMaxSize / 2) {
-            try {
-                std::allocator_traits<allocatorNode>::construct(alloc, forward, NodeMaxSize / 2,
-                                                                value);
-            } catch (...) {
-                throw std::runtime_error("Failure at constructing node while inserting");
-            }
+            std::allocator_traits<allocatorNode>::construct(alloc, forward, NodeMaxSize / 2,
+                                                            value);
         } else {
-            try {
-                std::allocator_traits<allocatorNode>::construct(alloc, forward, len, value);
-            } catch (...) {
-                throw std::runtime_error("Failure at constucting node while inserting");
-            }
+            std::allocator_traits<allocatorNode>::construct(alloc, forward, len, value);
         }
         back->link_forward(forward);
         len -= NodeMaxSize / 2;
@@ -437,24 +773,21 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
 
     return iterator(forward, forward->end);
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::insert(
     my_iterator<T, NodeMaxSize> point, my_iterator<T, NodeMaxSize> begin,
     my_iterator<T, NodeMaxSize> end) {
+    seal_gap();
     node<T, NodeMaxSize>* bufer = alloc.allocate(1);
     my_iterator<T, NodeMaxSize> p(point);
-    for (size_t i = 0; i < point.ptr->end - point.current - 1; ++i) {
-        try {
-            if constexpr (std::is_assignable_v<T, T>) {
-                bufer->arr[i] = point.ptr->arr[point.current + i + 1];
-            } else {
-                std::construct_at(bufer->arr + point.current + i + 1, point.ptr->arr[point.current + i + 1]);
-            }
-        } catch (...) {
-            throw std::runtime_error("Failure at insert");
+    for (size_t i = 0; i < point.ptr->end - point.index() - 1; ++i) {
+        if constexpr (std::is_assignable_v<T, T>) {
+            bufer->arr()[i] = point.ptr->arr()[point.index() + i + 1];
+        } else {
+            std::construct_at(bufer->arr() + point.index() + i + 1, point.ptr->arr()[point.index() + i + 1]);
         }
     }
-    bufer->end = point.ptr->end - point.current - 1;
+    bufer->end = point.ptr->end - point.index() - 1;
     end = ++point;
     node_capacity += 2;
     bufer->link_forward(point.ptr->next);
@@ -465,25 +798,20 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
     std::allocator_traits<allocatorNode>::construct(alloc, temp_tail);
 
     while (begin != end) {
-        ++capacity;
         if (temp_tail->end == NodeMaxSize / 2) {
             temp_tail = alloc.allocate(1);
             std::allocator_traits<allocatorNode>::construct(alloc, temp_tail);
             ++node_capacity;
             temp->link_forward(temp_tail);
         }
-        try {
-            if constexpr (std::is_assignable_v<T, T>) {
-                temp_tail->arr[temp_tail->end] = *begin;
-            } else {
-                std::construct_at(temp_tail->arr + temp_tail->end, *begin);
-            }
-        } catch (...) {
-            --capacity;
-            throw std::runtime_error("Failure at insert");
+        if constexpr (std::is_assignable_v<T, T>) {
+            temp_tail->arr()[temp_tail->end] = *begin;
+        } else {
+            std::construct_at(temp_tail->arr() + temp_tail->end, *begin);
         }
         ++begin;
         ++temp_tail->end;
+        ++capacity;
     }
 
     point.ptr->link_forward(temp_head);
@@ -494,99 +822,41 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
 
     return iterator(temp_tail, temp_tail->end);
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::insert(
     my_iterator<T, NodeMaxSize> point, std::initializer_list<T> init) {
     return insert(point, init.begin(), init.end());
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::erase(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::erase(
     my_iterator<T, NodeMaxSize> point) noexcept {
-    --capacity;
-    iterator res(point->erase(point.cur, point.cur));
-    while (point.ptr != res.ptr) {
-        --node_capacity;
-        point.ptr = point.ptr->next;
-    }
-    return res;
+    return erase(const_iterator(point));
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::erase(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::erase(
     my_iterator<T, NodeMaxSize> begin, my_iterator<T, NodeMaxSize> end) noexcept {
-    while (begin != end) {
-        if (begin.ptr != end.ptr) {
-            if (begin.cur == 0) {
-                capacity -= begin.ptr->end;
-                --node_capacity;
-                iterator temp(begin);
-                ++begin;
-                temp.ptr->prev->link_forward(temp.ptr->next);
-                temp.ptr->next = nullptr;
-                alloc.destroy(temp);
-            } else {
-                begin.ptr->erase(begin);
-                ++begin;
-            }
-        } else {
-            begin.ptr->erase(begin.current, end.current);
-        }
-        node<T, NodeMaxSize>* bufer = alloc.allocate(1);
-        std::allocator_traits<allocatorNode>::construct(alloc, bufer);
-        tail->thread_forward(bufer);
-        tail = bufer;
-    }
+    return erase(const_iterator(begin), const_iterator(end));
 }
 
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::insert(
     my_const_iterator<T, NodeMaxSize> it, T value) {
-    ++capacity;
-    if (it.ptr->end == NodeMaxSize) {
-        ++node_capacity;
-        node<T, NodeMaxSize>* bufer = alloc.allocate(1);
-        std::allocator_traits<allocatorNode>::construct(alloc, bufer);
-        it.ptr->thread_forward(bufer);
-        while (tail->next) {
-            tail = tail->next;
-        }
-        if (it.current > it.ptr->end) {
-            it.ptr = it.ptr->next;
-            it.current -= NodeMaxSize / 2 + 1;
-        }
-    }
-    std::reverse(it.ptr->arr + it.current, it.ptr->arr + it.ptr->end);
-    std::reverse(it.ptr->arr + it.current, it.ptr->arr + it.ptr->end + 1);
-    try {
-        if constexpr (std::is_assignable_v<T, T>) {
-            it.ptr->arr[it.current] = value;
-        } else {
-            std::construct_at(it.ptr->arr + it.current, value);
-        }
-    } catch (...) {
-        std::reverse(it.ptr->arr + it.current, it.ptr->arr + it.ptr->end + 1);
-        std::reverse(it.ptr->arr + it.current, it.ptr->arr + it.ptr->end);
-        throw std::runtime_error("Failure at insert");
-    }
-    ++it.ptr->end;
-    return it;
+    return insert(iterator(const_cast<node<T, NodeMaxSize>*>(it.ptr), it.index()), value);
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::insert(
     my_const_iterator<T, NodeMaxSize> it, size_t n, T value) {
+    seal_gap();
     node<T, NodeMaxSize>* bufer = alloc.allocate(1);
-    for (size_t i = 0; i < it.ptr->end - it.current - 1; ++i) {
-        try {
-            if constexpr (std::is_assignable_v<T, T>) {
-                bufer->arr[i] = it.ptr->arr[it.current + i + 1];
-            } else {
-                std::construct_at(bufer->arr + it.current + i + 1, *((i + 1) + it));
-            }
-        } catch (...) {
-            throw std::runtime_error("Failure at insert");
+    for (size_t i = 0; i < it.ptr->end - it.index() - 1; ++i) {
+        if constexpr (std::is_assignable_v<T, T>) {
+            bufer->arr()[i] = it.ptr->arr()[it.index() + i + 1];
+        } else {
+            std::construct_at(bufer->arr() + it.index() + i + 1, *((i + 1) + it));
         }
     }
-    bufer->end = it.ptr->end - it.current - 1;
-    end = it.current + 1;
+    bufer->end = it.ptr->end - it.index() - 1;
+    end = it.index() + 1;
     node_capacity += 2;
     bufer->link_forward(it->ptr->next);
 
@@ -596,17 +866,9 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
     size_t len = n;
 
     if (len > NodeMaxSize / 2) {
-        try {
-            std::allocator_traits<allocatorNode>::construct(alloc, forward, NodeMaxSize / 2, value);
-        } catch (...) {
-            throw std::runtime_error("Failure at constructing node while inserting");
-        }
+        std::allocator_traits<allocatorNode>::construct(alloc, forward, NodeMaxSize / 2, value);
     } else {
-        try {
-            std::allocator_traits<allocatorNode>::construct(alloc, forward, len, value);
-        } catch (...) {
-            throw std::runtime_error("Failure at constucting node while inserting");
-        }
+        std::allocator_traits<allocatorNode>::construct(alloc, forward, len, value);
     }
     len -= NodeMaxSize / 2;
 
@@ -614,18 +876,10 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
         node<T, NodeMaxSize>* back = forward;
         forward = alloc.allocate(1);
         if (len > NodeMaxSize / 2) {
-            try {
-                std::allocator_traits<allocatorNode>::construct(alloc, forward, NodeMaxSize / 2,
-                                                                value);
-            } catch (...) {
-                throw std::runtime_error("Failure at constructing node while inserting");
-            }
+            std::allocator_traits<allocatorNode>::construct(alloc, forward, NodeMaxSize / 2,
+                                                            value);
         } else {
-            try {
-                std::allocator_traits<allocatorNode>::construct(alloc, forward, len, value);
-            } catch (...) {
-                throw std::runtime_error("Failure at constucting node while inserting");
-            }
+            std::allocator_traits<allocatorNode>::construct(alloc, forward, len, value);
         }
         back->link_forward(forward);
         len -= NodeMaxSize / 2;
@@ -640,24 +894,21 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
 
     return const_iterator(forward, forward->end);
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::insert(
     my_const_iterator<T, NodeMaxSize> point, my_iterator<T, NodeMaxSize> begin,
     my_iterator<T, NodeMaxSize> end) {
+    seal_gap();
     node<T, NodeMaxSize>* bufer = alloc.allocate(1);
     for (size_t i = 0; i < point->ptr->end - point->current - 1; ++i) {
-        try {
-            if constexpr (std::is_assignable_v<T, T>) {
-                bufer->arr[i] = point.ptr->arr[point.current + i + 1];
-            } else {
-                std::construct_at(bufer->arr + point.current + i + 1, *((i + 1) + point));
-            }
-        } catch (...) {
-            throw std::runtime_error("Failure at insert");
+        if constexpr (std::is_assignable_v<T, T>) {
+            bufer->arr()[i] = point.ptr->arr()[point.index() + i + 1];
+        } else {
+            std::construct_at(bufer->arr() + point.index() + i + 1, *((i + 1) + point));
         }
     }
     bufer->end = point->ptr->end - point->current - 1;
-    end = point.current + 1;
+    end = point.index() + 1;
     node_capacity += 2;
     bufer->link_forward(point->ptr->next);
 
@@ -667,25 +918,20 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
     std::allocator_traits<allocatorNode>::construct(temp_tail);
 
     while (begin != end) {
-        ++capacity;
         if (temp_tail->end == NodeMaxSize / 2) {
             temp_tail = alloc.allocate(1);
             std::allocator_traits<allocatorNode>::construct(temp_tail);
             temp->link_forward(temp_tail);
             ++node_capacity;
         }
-        try {
-            if constexpr (std::is_assignable_v<T, T>) {
-                temp_tail->arr[temp_tail->end] = *begin;
-            } else {
-                std::construct_at(temp_tail->arr + temp_tail->end, *begin);
-            }
-        } catch (...) {
-            --capacity;
-            throw std::runtime_error("Failure at insert");
+        if constexpr (std::is_assignable_v<T, T>) {
+            temp_tail->arr()[temp_tail->end] = *begin;
+        } else {
+            std::construct_at(temp_tail->arr() + temp_tail->end, *begin);
         }
         ++begin;
         ++temp_tail->end;
+        ++capacity;
     }
 
     point->ptr->link_forward(temp_head);
@@ -697,54 +943,103 @@ my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
 
     return const_iterator(temp_tail, temp_tail->end);
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::insert(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::insert(
     my_const_iterator<T, NodeMaxSize> point, std::initializer_list<T> init) {
     return insert(point, init.begin(), init.end());
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::erase(
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::erase(
     my_const_iterator<T, NodeMaxSize> point) noexcept {
-    --capacity;
-    iterator res(point->erase(point.cur, point.cur));
-    while (point.ptr != res.ptr) {
-        --node_capacity;
-        point.ptr = point.ptr->next;
-    }
-    return res;
+    return erase(point, std::next(point));
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator>::erase(
+// Trims the two boundary nodes and unlinks every node strictly between them, so the cost
+// is one step per node plus the elements of the boundary nodes.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+my_iterator<T, NodeMaxSize> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::erase(
     my_const_iterator<T, NodeMaxSize> begin, my_const_iterator<T, NodeMaxSize> end) noexcept {
-    while (begin != end) {
-        if (begin.ptr != end.ptr) {
-            if (begin.cur == 0) {
-                capacity -= begin.ptr->end;
-                --node_capacity;
-                iterator temp(begin);
-                ++begin;
-                temp.ptr->prev->link_forward(temp.ptr->next);
-                temp.ptr->next = nullptr;
-                alloc.destroy(temp);
-            } else {
-                begin.ptr->erase(begin);
-                ++begin;
-            }
-        } else {
-            begin.ptr->erase(begin.current, end.current);
+    typename Instrumentation::scope timer(list_op::erase);
+    seal_gap();
+    node<T, NodeMaxSize>* first = const_cast<node<T, NodeMaxSize>*>(begin.ptr);
+    node<T, NodeMaxSize>* last = const_cast<node<T, NodeMaxSize>*>(end.ptr);
+    size_t from = begin.index();
+    size_t to = end.index();
+    if (first == last && from == to) {
+        return iterator(first, from);
+    }
+    forget_positions();
+    if (first == last) {
+        erase_slots(first, from, to);
+        to = from;
+    } else {
+        erase_slots(first, from, first->end);
+        while (first->next != last) {
+            node<T, NodeMaxSize>* temp = first->next;
+            capacity -= temp->end;
+            unlink_node(temp);
         }
+        erase_slots(last, 0, to);
+        to = 0;
+    }
+    // drop boundary nodes that ended up empty, keeping at least one node in the list
+    if (last->end == 0 && node_capacity > 1) {
+        node<T, NodeMaxSize>* temp = last->next;
+        if (first == last) {
+            first = nullptr;
+        }
+        unlink_node(last);
+        last = temp;
+        to = 0;
+    }
+    if (first && first != last && first->end == 0 && node_capacity > 1) {
+        unlink_node(first);
+    }
+    if (!last) {
+        return this->end();
     }
+    if (to == last->end && last->next) {
+        return iterator(last->next, 0);
+    }
+    return iterator(last, to);
 }
 
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::clear() noexcept {
-    std::allocator_traits<allocatorNode>::destroy(alloc, head);
-    std::allocator_traits<allocatorNode>::construct(alloc, head);
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::clear(
+    size_t retain_nodes) noexcept {
+    seal_gap();
+    finish_defragment();
+    forget_positions();
+    node<T, NodeMaxSize>* temp = head->next;
+    std::destroy(head->arr(), head->arr() + head->end);
+    head->end = 0;
+    head->next = nullptr;
     tail = head;
+    while (temp) {
+        node<T, NodeMaxSize>* next = temp->next;
+        if (spare_count < retain_nodes) {
+            std::destroy(temp->arr(), temp->arr() + temp->end);
+            temp->end = 0;
+            temp->prev = nullptr;
+            temp->next = spare;
+            spare = temp;
+            ++spare_count;
+        } else {
+            destroy_node(temp);
+        }
+        temp = next;
+    }
+    capacity = 0;
+    node_capacity = 1;
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::assign(const_iterator begin,
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::trim(size_t max_nodes) noexcept {
+    release_spares(max_nodes);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::assign(const_iterator begin,
                                                       const_iterator end) noexcept {
+    seal_gap();
+    forget_positions();
     std::allocator_traits<allocatorNode>::destroy(alloc, head);
     std::allocator_traits<allocatorNode>::construct(alloc, head);
     tail = head;
@@ -756,12 +1051,15 @@ void unrolled_list<T, NodeMaxSize, Allocator>::assign(const_iterator begin,
         ++begin;
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::assign(std::initializer_list<T> init) noexcept {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::assign(
+    std::initializer_list<T> init) noexcept {
     this->assign(init.begin(), init.end());
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::assign(size_t n, T value) noexcept {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::assign(size_t n, T value) noexcept {
+    seal_gap();
+    forget_positions();
     std::allocator_traits<allocatorNode>::destroy(alloc, head);
     std::allocator_traits<allocatorNode>::construct(alloc, head, n, value);
     tail = head;
@@ -769,104 +1067,815 @@ void unrolled_list<T, NodeMaxSize, Allocator>::assign(size_t n, T value) noexcep
         tail = tail->next;
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::push_back(const T& value) {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::push_back(
+    const T& value) {
+    typename Instrumentation::scope timer(list_op::push);
+    seal_gap();
     if (tail->end == NodeMaxSize) {
-        node<T, NodeMaxSize>* bufer = alloc.allocate(1);
-        std::allocator_traits<allocatorNode>::construct(alloc, bufer);
-        tail->thread_forward(bufer);
+        // a full tail is left as is: appends fill fresh nodes instead of moving half of it
+        node<T, NodeMaxSize>* bufer = start_node(value);
+        tail->link_forward(bufer);
         tail = bufer;
         ++node_capacity;
+        ++capacity;
+        number_tail();
+        return;
     }
-    if constexpr (std::is_assignable_v<T, T>) {
+    std::construct_at(tail->arr() + tail->end, value);
+    ++capacity;
+    ++tail->end;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+template <std::ranges::input_range Range>
+void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::append_range(Range&& range) {
+    seal_gap();
+    auto it = std::ranges::begin(range);
+    auto last = std::ranges::end(range);
+    for (; it != last && tail->end < NodeMaxSize; ++it) {
+        push_back(*it);
+    }
+    while (it != last) {
+        node<T, NodeMaxSize>* bufer = create_node();
         try {
-            tail->arr[tail->end] = value;
+            for (; it != last && bufer->end < NodeMaxSize; ++it) {
+                std::construct_at(bufer->arr() + bufer->end, *it);
+                ++bufer->end;
+            }
         } catch (...) {
-            throw std::runtime_error("");
-        }
-    } else {
-        try {
-            std::construct_at(tail->arr + tail->end, value);
-        } catch (std::runtime_error) {
-            throw std::runtime_error("");
+            recycle_node(bufer);
+            throw;
         }
+        tail->link_forward(bufer);
+        tail = bufer;
+        ++node_capacity;
+        capacity += bufer->end;
+        number_tail();
     }
-    ++capacity;
-    ++tail->end;
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::push_front(const T& value) {
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::push_front(
+    const T& value) {
+    typename Instrumentation::scope timer(list_op::push);
+    seal_gap();
     if (head->end == NodeMaxSize) {
-        node<T, NodeMaxSize>* bufer = alloc.allocate(1);
-        std::allocator_traits<allocatorNode>::construct(alloc, bufer);
-        head->thread_back(bufer);
+        node<T, NodeMaxSize>* bufer = start_node(value);
+        bufer->link_forward(head);
+        head = bufer;
         ++node_capacity;
-        while (tail->next) {
-            tail = tail->next;
-        }
+        ++capacity;
+        --bias;
+        number_head();
+        return;
+    }
+    T* first = head->arr();
+    T* last = first + head->end;
+    if (first == last) {
+        std::construct_at(first, value);
+    } else {
+        // the copy is made before anything moves: `value` may be an element of this node,
+        // and a throwing copy leaves the node untouched
+        T copy(value);
+        std::construct_at(last, std::move(last[-1]));
+        std::move_backward(first, last - 1, last);
+        *first = std::move(copy);
     }
-    *head >> 1;
     ++head->end;
-    if constexpr (std::is_assignable_v<T, T>) {
-        try {
-            head->arr[0] = value;
-        } catch (...) {
-            *head << 1;
-            --head->end;
-            throw std::runtime_error("");
+    ++capacity;
+    --bias;
+    if (head->end == 1 && head->next) {
+        number_head();
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::pop_back() noexcept {
+    typename Instrumentation::scope timer(list_op::pop);
+    seal_gap();
+    if (capacity == 0) {
+        return;
+    }
+    while (tail->end == 0) {
+        node<T, NodeMaxSize>* temp = tail;
+        tail = tail->prev;
+        tail->next = nullptr;
+        recycle_node(temp);
+        --node_capacity;
+    }
+    tail->pop_back();
+    --capacity;
+    if (tail->end == 0 && tail->prev) {
+        node<T, NodeMaxSize>* temp = tail;
+        tail = tail->prev;
+        tail->next = nullptr;
+        recycle_node(temp);
+        --node_capacity;
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::pop_front() noexcept {
+    typename Instrumentation::scope timer(list_op::pop);
+    seal_gap();
+    if (capacity == 0) {
+        return;
+    }
+    while (head->end == 0) {
+        node<T, NodeMaxSize>* temp = head;
+        head = head->next;
+        head->prev = nullptr;
+        recycle_node(temp);
+        --node_capacity;
+    }
+    head->pop_front();
+    --capacity;
+    ++bias;
+    if (head->end == 0 && head->next) {
+        node<T, NodeMaxSize>* temp = head;
+        head = head->next;
+        head->prev = nullptr;
+        recycle_node(temp);
+        --node_capacity;
+    }
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::pop_front_n(
+    size_t count) noexcept {
+    typename Instrumentation::scope timer(list_op::pop);
+    seal_gap();
+    count = std::min(count, capacity);
+    bias += count;
+    while (head->next && count >= head->end) {
+        count -= head->end;
+        capacity -= head->end;
+        unlink_node(head);
+    }
+    erase_slots(head, 0, count);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::pop_back_n(
+    size_t count) noexcept {
+    typename Instrumentation::scope timer(list_op::pop);
+    seal_gap();
+    count = std::min(count, capacity);
+    while (tail->prev && count >= tail->end) {
+        count -= tail->end;
+        capacity -= tail->end;
+        unlink_node(tail);
+    }
+    erase_slots(tail, tail->end - count, tail->end);
+}
+// Unlinks a node from the chain and hands it to the spare cache; its elements
+// must already be accounted for in `capacity`.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::unlink_node(
+    node<T, NodeMaxSize>* target) noexcept {
+    if (target->prev) {
+        target->prev->next = target->next;
+    } else {
+        head = target->next;
+    }
+    if (target->next) {
+        target->next->prev = target->prev;
+    } else {
+        tail = target->prev;
+    }
+    target->next = nullptr;
+    target->prev = nullptr;
+    recycle_node(target);
+    --node_capacity;
+}
+// Removes slots [from, to) of one node and closes the gap.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::erase_slots(
+    node<T, NodeMaxSize>* target, size_t from, size_t to) noexcept {
+    if (from == to) {
+        return;
+    }
+    T* last = std::move(target->arr() + to, target->arr() + target->end, target->arr() + from);
+    std::destroy(last, target->arr() + target->end);
+    target->end -= to - from;
+    capacity -= to - from;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::refresh_positions() noexcept {
+    if (head && head->stamp != epoch) {
+        renumber();
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr size_t unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::index_of(
+    const_iterator it) {
+    refresh_positions();
+    return std::as_const(*this).index_of(it);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr size_t unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::index_of(
+    const_iterator it) const {
+    if (!it.ptr) {
+        return 0;
+    }
+    if (head->stamp == epoch) {
+        return prefix_of(it.ptr) + it.index();
+    }
+    size_t res = 0;
+    for (const node<T, NodeMaxSize>* temp = head; temp != it.ptr; temp = temp->next) {
+        res += temp->end;
+    }
+    return res + it.index();
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr std::ptrdiff_t unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::distance(
+    const_iterator first, const_iterator last) {
+    refresh_positions();
+    return std::as_const(*this).distance(first, last);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr std::ptrdiff_t unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::distance(
+    const_iterator first, const_iterator last) const {
+    return static_cast<std::ptrdiff_t>(index_of(last) - index_of(first));
+}
+// Ordinals start mid-range so nodes pushed at the front can count down from the head.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::renumber() noexcept {
+    size_t ordinal = std::numeric_limits<size_t>::max() / 2;
+    size_t prefix = 0;
+    for (node<T, NodeMaxSize>* temp = head; temp; temp = temp->next) {
+        temp->ordinal = ordinal++;
+        temp->prefix = prefix + bias;
+        temp->stamp = epoch;
+        prefix += temp->end;
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr size_t unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::prefix_of(
+    const node<T, NodeMaxSize>* target) const noexcept {
+    return target->prev ? target->prefix - bias : 0;
+}
+// Number a node just linked after the tail or before the head from its neighbour. The
+// ordinal only has to stay ordered, the prefix matters while positions are current.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::number_tail() noexcept {
+    node<T, NodeMaxSize>* before = tail->prev;
+    tail->ordinal = before->ordinal + 1;
+    tail->prefix = prefix_of(before) + before->end + bias;
+    tail->stamp = before->stamp;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::number_head() noexcept {
+    node<T, NodeMaxSize>* after = head->next;
+    head->ordinal = after->ordinal - 1;
+    after->prefix = head->end + bias;
+    head->stamp = after->stamp;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr const char*
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::broken_invariant() const noexcept {
+    if (!head || !tail || head->prev || tail->next) {
+        return "head or tail is not an end of the chain";
+    }
+    bool positions = head->stamp == epoch;
+    bool gap_seen = false;
+    size_t elements = 0;
+    size_t nodes = 0;
+    for (const node<T, NodeMaxSize>* temp = head; temp; temp = temp->next) {
+        if (temp->next ? temp->next->prev != temp : temp != tail) {
+            return "next and prev links disagree";
+        }
+        if (temp->end > NodeMaxSize) {
+            return "node filled past NodeMaxSize";
+        }
+        if (temp == gapped) {
+            gap_seen = true;
+            if (temp->gap_at > temp->end || temp->end + temp->gap_size > NodeMaxSize) {
+                return "open gap out of the node bounds";
+            }
+        } else if (temp->gap_size != 0) {
+            return "gap left open outside the gapped node";
         }
+        if (positions) {
+            if (temp->stamp != epoch) {
+                return "node left unnumbered while positions are current";
+            }
+            if (temp->prev && temp->prev->ordinal >= temp->ordinal) {
+                return "node ordinals out of order";
+            }
+            if (prefix_of(temp) != elements) {
+                return "node prefix out of date";
+            }
+        }
+        elements += temp->end;
+        if (++nodes > node_capacity) {
+            return "more nodes in the chain than node_capacity";
+        }
+    }
+    if (elements != capacity) {
+        return "capacity does not match the elements in the chain";
+    }
+    if (nodes != node_capacity) {
+        return "node_capacity does not match the chain";
+    }
+    if (gapped && !gap_seen) {
+        return "gapped node is not in the chain";
+    }
+    size_t spares = 0;
+    for (const node<T, NodeMaxSize>* temp = spare; temp; temp = temp->next) {
+        if (temp->end != 0 || temp->prev) {
+            return "spare node is not empty and unlinked";
+        }
+        if (++spares > spare_count) {
+            break;
+        }
+    }
+    if (spares != spare_count) {
+        return "spare_count does not match the spare cache";
+    }
+    return nullptr;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::set_spare_nodes(
+    size_t limit) noexcept {
+    spare_limit = limit;
+    release_spares(limit);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::reserve_nodes(size_t count) {
+    if (spare_limit < count) {
+        spare_limit = count;
+    }
+    while (spare_count < count) {
+        node<T, NodeMaxSize>* bufer = alloc.allocate(1);
+        std::allocator_traits<allocatorNode>::construct(alloc, bufer);
+        bufer->next = spare;
+        spare = bufer;
+        ++spare_count;
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr node<T, NodeMaxSize>*
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::create_node() {
+    typename Instrumentation::scope timer(list_op::node_alloc);
+    if (!spare) {
+        node<T, NodeMaxSize>* bufer = alloc.allocate(1);
+        std::allocator_traits<allocatorNode>::construct(alloc, bufer);
+        return bufer;
+    }
+    node<T, NodeMaxSize>* bufer = spare;
+    spare = bufer->next;
+    bufer->next = nullptr;
+    bufer->stamp = 0;
+    --spare_count;
+    return bufer;
+}
+// A node holding just `value`, not linked yet: if the copy throws, the node goes back to
+// the cache and the list is left exactly as it was.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr node<T, NodeMaxSize>*
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::start_node(const T& value) {
+    node<T, NodeMaxSize>* bufer = create_node();
+    if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+        std::construct_at(bufer->arr(), value);
     } else {
         try {
-            std::construct_at(head->arr, value);
+            std::construct_at(bufer->arr(), value);
         } catch (...) {
-            *head << 1;
-            --head->end;
-            throw std::runtime_error("");
+            recycle_node(bufer);
+            throw;
         }
     }
-    ++capacity;
+    bufer->end = 1;
+    return bufer;
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::pop_back() noexcept {
-    while (tail->end == 0) {
-        if (tail->prev) {
-            node<T, NodeMaxSize>* temp = tail;
-            tail = tail->prev;
-            temp->prev->link_forward(temp->next);
-            temp->next = nullptr;
+// Takes an already unlinked node; keeps it as a spare while the cache has room.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::recycle_node(
+    node<T, NodeMaxSize>* target) noexcept {
+    typename Instrumentation::scope timer(list_op::node_free);
+    if (target == gapped) {
+        seal_gap();
+    }
+    if (spare_count >= spare_limit) {
+        destroy_node(target);
+        return;
+    }
+    if (target == defrag_source || target == defrag_out) {
+        finish_defragment();
+    }
+    std::destroy(target->arr(), target->arr() + target->end);
+    target->end = 0;
+    target->prev = nullptr;
+    target->next = spare;
+    spare = target;
+    ++spare_count;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::release_spares(
+    size_t keep) noexcept {
+    while (spare_count > keep) {
+        node<T, NodeMaxSize>* temp = spare;
+        spare = temp->next;
+        --spare_count;
+        destroy_node(temp);
+    }
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::defragment() {
+    while (!defragment_step(std::numeric_limits<size_t>::max())) {
+    }
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+bool unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::defragment_step(size_t budget) {
+    seal_gap();
+    if (!defrag_source) {
+        if (capacity == 0) {
+            return true;
+        }
+        defrag_source = head;
+        defrag_out = nullptr;
+        defrag_moved = 0;
+    }
+    forget_positions();
+    for (; budget > 0 && defrag_source; --budget) {
+        node<T, NodeMaxSize>* source = defrag_source;
+        size_t moved = 0;
+        try {
+            for (; moved < source->end; ++moved) {
+                // a node spliced in by the user between two steps breaks the run
+                if (!defrag_out || defrag_out->end == NodeMaxSize || defrag_out->next != source) {
+                    node<T, NodeMaxSize>* bufer = take_slab_node();
+                    if (source->prev) {
+                        source->prev->link_forward(bufer);
+                    } else {
+                        head = bufer;
+                    }
+                    bufer->link_forward(source);
+                    defrag_out = bufer;
+                }
+                std::construct_at(defrag_out->arr() + defrag_out->end,
+                                  std::move(source->arr()[moved]));
+                std::destroy_at(source->arr() + moved);
+                ++defrag_out->end;
+                ++defrag_moved;
+            }
+        } catch (...) {
+            for (size_t i = moved; i < source->end; ++i) {
+                std::construct_at(source->arr() + i - moved, std::move(source->arr()[i]));
+                std::destroy_at(source->arr() + i);
+            }
+            source->end -= moved;
+            throw;
+        }
+        source->end = 0;
+        defrag_source = source->next;
+
+        if (source->prev) {
+            source->prev->next = source->next;
         } else {
-            return;
+            head = source->next;
         }
+        if (source->next) {
+            source->next->prev = source->prev;
+        } else {
+            tail = source->prev;
+        }
+        destroy_node(source);
+        --node_capacity;
     }
-    tail->pop_back();
+    if (defrag_source) {
+        return false;
+    }
+    finish_defragment();
+    return true;
+}
 
-    while (tail->next != nullptr) {
-        tail = tail->next;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::destroy_node(
+    node<T, NodeMaxSize>* target) noexcept {
+    if (target == gapped) {
+        seal_gap();
+    }
+    if (target == defrag_source || target == defrag_out) {
+        finish_defragment();
     }
-    while (head->prev != nullptr) {
-        head = head->prev;
+    node_slab<T, NodeMaxSize>* slab = target->slab;
+    std::allocator_traits<allocatorNode>::destroy(alloc, target);
+    if (!slab) {
+        alloc.deallocate(target, 1);
+    } else if (--slab->live == 0 && slab != defrag_slab) {
+        release_slab(slab);
     }
 }
-template <typename T, size_t NodeMaxSize, typename Allocator>
-void unrolled_list<T, NodeMaxSize, Allocator>::pop_front() noexcept {
-    while (head->end == 0) {
-        if (head->next) {
-            node<T, NodeMaxSize>* temp = head;
-            head = head->next;
-            temp->prev->link_forward(temp->next);
-            temp->next = nullptr;
-            std::allocator_traits<allocatorNode>::destroy(alloc, temp);
-        } else {
-            return;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+node<T, NodeMaxSize>* unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::take_slab_node() {
+    if (!defrag_slab || defrag_slab->used == defrag_slab->size) {
+        // an estimate, as the user may change the list between steps: a short slab is
+        // followed by another one
+        size_t left = capacity > defrag_moved ? capacity - defrag_moved : 0;
+        size_t count = std::max<size_t>(1, (left + NodeMaxSize - 1) / NodeMaxSize);
+
+        allocatorSlab slab_alloc(alloc);
+        node_slab<T, NodeMaxSize>* slab = slab_alloc.allocate(1);
+        try {
+            std::allocator_traits<allocatorSlab>::construct(
+                slab_alloc, slab, node_slab<T, NodeMaxSize>{alloc.allocate(count), count, 0, 0});
+        } catch (...) {
+            slab_alloc.deallocate(slab, 1);
+            throw;
+        }
+        node_slab<T, NodeMaxSize>* full = defrag_slab;
+        defrag_slab = slab;
+        if (full && full->live == 0) {
+            release_slab(full);
         }
     }
-    head->pop_front();
+    node<T, NodeMaxSize>* result = defrag_slab->base + defrag_slab->used;
+    std::allocator_traits<allocatorNode>::construct(alloc, result);
+    result->slab = defrag_slab;
+    ++defrag_slab->used;
+    ++defrag_slab->live;
+    ++node_capacity;
+    return result;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::release_slab(
+    node_slab<T, NodeMaxSize>* slab) noexcept {
+    allocatorSlab slab_alloc(alloc);
+    alloc.deallocate(slab->base, slab->size);
+    std::allocator_traits<allocatorSlab>::destroy(slab_alloc, slab);
+    slab_alloc.deallocate(slab, 1);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+constexpr void
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::finish_defragment() noexcept {
+    node_slab<T, NodeMaxSize>* slab = defrag_slab;
+    defrag_slab = nullptr;
+    defrag_source = nullptr;
+    defrag_out = nullptr;
+    defrag_moved = 0;
+    if (slab && slab->live == 0) {
+        release_slab(slab);
+    }
+}
 
-    while (tail->next != nullptr) {
-        tail = tail->next;
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+template <typename Gen>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::from_parallel(
+    size_t n, Gen gen, parallel_policy policy, const Allocator& al) {
+    return build_parallel(n, policy, al, [&gen](size_t first, size_t last, auto& put) {
+        for (size_t i = first; i < last; ++i) {
+            put(gen(i));
+        }
+    });
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+template <typename Func>
+auto unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::transform_to(Func func, parallel_policy policy) const {
+    typedef std::remove_cvref_t<std::invoke_result_t<Func&, const T&>> result_type;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<result_type>
+        result_allocator;
+    typedef unrolled_list<result_type, NodeMaxSize, result_allocator, Instrumentation>
+        result_list;
+
+    // where every source node starts, so a worker can seek to its first element
+    std::unique_ptr<const node<T, NodeMaxSize>*[]> sources(
+        new const node<T, NodeMaxSize>*[node_capacity]);
+    std::unique_ptr<size_t[]> starts(new size_t[node_capacity]);
+    size_t count = 0;
+    for (const node<T, NodeMaxSize>* temp = head; temp; temp = temp->next, ++count) {
+        sources[count] = temp;
+        starts[count] = count ? starts[count - 1] + sources[count - 1]->end : 0;
+    }
+    return result_list::build_parallel(
+        capacity, policy, result_allocator(alloc), [&](size_t first, size_t last, auto& put) {
+            size_t index = std::upper_bound(starts.get(), starts.get() + count, first) -
+                           starts.get() - 1;
+            const node<T, NodeMaxSize>* source = sources[index];
+            size_t offset = first - starts[index];
+            for (size_t i = first; i < last; ++i, ++offset) {
+                while (offset == source->end) {
+                    source = source->next;
+                    offset = 0;
+                }
+                put(func(source->at(offset)));
+            }
+        });
+}
+// The list is cut into runs of `grain` nodes. Worker w starts with a contiguous share of
+// the runs packed as [begin, end) into one atomic word; it takes runs from the front of its
+// own share and, once that is empty, steals the back half of another worker's share.
+// Runs are node aligned, so every node but the very last one ends up full.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+template <typename Fill>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation> unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::build_parallel(
+    size_t n, parallel_policy policy, const Allocator& al, Fill fill) {
+    unrolled_list res(al);
+    if (n == 0) {
+        return res;
+    }
+    size_t total = (n + NodeMaxSize - 1) / NodeMaxSize;
+    size_t grain = std::max<size_t>(1, policy.grain);
+    size_t runs = (total + grain - 1) / grain;
+    size_t workers = policy.threads ? policy.threads : std::thread::hardware_concurrency();
+    workers = std::clamp<size_t>(workers, 1, runs);
+
+    allocatorSlab slab_alloc(res.alloc);
+    node_slab<T, NodeMaxSize>* slab = slab_alloc.allocate(1);
+    try {
+        std::allocator_traits<allocatorSlab>::construct(
+            slab_alloc, slab,
+            node_slab<T, NodeMaxSize>{res.alloc.allocate(total), total, total, 0});
+    } catch (...) {
+        slab_alloc.deallocate(slab, 1);
+        throw;
+    }
+    node<T, NodeMaxSize>* base = slab->base;
+
+    struct alignas(64) share {
+        std::atomic<uint64_t> range;
+    };
+    std::unique_ptr<share[]> shares(new share[workers]);
+    for (size_t w = 0; w < workers; ++w) {
+        shares[w].range.store(((runs * w / workers) << 32) | (runs * (w + 1) / workers));
+    }
+    // nodes constructed by each run, to unwind a build that threw
+    std::unique_ptr<size_t[]> built(new size_t[runs]());
+    std::atomic<bool> failed = false;
+    std::exception_ptr error;
+
+    auto fill_run = [&](size_t run) {
+        size_t first_node = run * grain;
+        size_t last_node = std::min(total, first_node + grain);
+        node<T, NodeMaxSize>* cur = base + first_node;
+        std::allocator_traits<allocatorNode>::construct(res.alloc, cur);
+        cur->slab = slab;
+        built[run] = 1;
+        auto put = [&](auto&& value) {
+            if (cur->end == NodeMaxSize) {
+                node<T, NodeMaxSize>* bufer = cur + 1;
+                std::allocator_traits<allocatorNode>::construct(res.alloc, bufer);
+                bufer->slab = slab;
+                ++built[run];
+                cur->link_forward(bufer);
+                cur = bufer;
+            }
+            std::construct_at(cur->arr() + cur->end, std::forward<decltype(value)>(value));
+            ++cur->end;
+        };
+        fill(first_node * NodeMaxSize, std::min(n, last_node * NodeMaxSize), put);
+    };
+    auto take = [](std::atomic<uint64_t>& range, size_t& run) {
+        uint64_t cur = range.load();
+        while ((cur >> 32) < (cur & 0xffffffff)) {
+            if (range.compare_exchange_weak(cur, cur + (uint64_t(1) << 32))) {
+                run = cur >> 32;
+                return true;
+            }
+        }
+        return false;
+    };
+    auto steal = [&](size_t self, size_t& run) {
+        for (size_t i = 1; i < workers; ++i) {
+            std::atomic<uint64_t>& victim = shares[(self + i) % workers].range;
+            uint64_t cur = victim.load();
+            while ((cur >> 32) < (cur & 0xffffffff)) {
+                uint64_t begin = cur >> 32;
+                uint64_t end = cur & 0xffffffff;
+                uint64_t mid = begin + (end - begin) / 2;
+                if (victim.compare_exchange_weak(cur, (begin << 32) | mid)) {
+                    run = mid;
+                    shares[self].range.store(((mid + 1) << 32) | end);
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    auto work = [&](size_t self) {
+        size_t run = 0;
+        try {
+            while (!failed.load(std::memory_order_relaxed) &&
+                   (take(shares[self].range, run) || steal(self, run))) {
+                fill_run(run);
+            }
+        } catch (...) {
+            if (!failed.exchange(true)) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    std::unique_ptr<std::thread[]> threads(new std::thread[workers - 1]);
+    size_t started = 0;
+    try {
+        for (; started + 1 < workers; ++started) {
+            threads[started] = std::thread(work, started + 1);
+        }
+    } catch (...) {
+        if (!failed.exchange(true)) {
+            error = std::current_exception();
+        }
+    }
+    work(0);
+    for (size_t i = 0; i < started; ++i) {
+        threads[i].join();
     }
 
-    while (head->prev != nullptr) {
-        head = head->prev;
+    if (error) {
+        for (size_t run = 0; run < runs; ++run) {
+            for (size_t i = 0; i < built[run]; ++i) {
+                std::allocator_traits<allocatorNode>::destroy(res.alloc, base + run * grain + i);
+            }
+        }
+        res.release_slab(slab);
+        std::rethrow_exception(error);
+    }
+    for (size_t run = 1; run < runs; ++run) {
+        base[run * grain - 1].link_forward(base + run * grain);
     }
+    res.destroy_node(res.head);
+    slab->live = total;
+    res.head = base;
+    res.tail = base + total - 1;
+    res.capacity = n;
+    res.node_capacity = total;
+    return res;
+}
+
+namespace pmr {
+template <typename T, size_t NodeMaxSize = 10>
+using unrolled_list = ::unrolled_list<T, NodeMaxSize, std::pmr::polymorphic_allocator<T>>;
 }
+
+// Hashes the elements in bulk: payloads of bytewise comparable scalars are fed to the mixer
+// segment by segment as raw words, other types through std::hash one by one. The result
+// depends only on the sequence, not on how it is spread over nodes. Only the raw path is
+// noexcept, since std::hash<T> of a user type may throw.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+struct std::hash<unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>> {
+    size_t operator()(const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list) const
+        noexcept(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>::bytewise_comparable) {
+        state hasher;
+        for (const node<T, NodeMaxSize>* temp = list.head; temp; temp = temp->next) {
+            if constexpr (unrolled_list<T, NodeMaxSize, Allocator,
+                                        Instrumentation>::bytewise_comparable) {
+                hasher.update(reinterpret_cast<const unsigned char*>(&temp->at(0)),
+                              temp->end * sizeof(T));
+            } else {
+                for (size_t i = 0; i < temp->end; ++i) {
+                    uint64_t word = std::hash<T>()(temp->at(i));
+                    hasher.update(reinterpret_cast<const unsigned char*>(&word), sizeof(word));
+                }
+            }
+        }
+        return hasher.finish(list.size());
+    }
+
+   private:
+    // 64-bit multiply-rotate mixer over 8-byte words; bytes left over from one segment
+    // are carried into the next so segment boundaries don't change the result.
+    struct state {
+        static constexpr uint64_t k1 = 0x9e3779b97f4a7c15ull;
+        static constexpr uint64_t k2 = 0xff51afd7ed558ccdull;
+
+        uint64_t acc = 0x243f6a8885a308d3ull;
+        unsigned char carry[8] = {};
+        size_t carry_len = 0;
+
+        inline void mix(uint64_t word) { acc = (std::rotl(acc ^ (word * k1), 29) + k2) * k1; }
+        inline void mix_bytes(const unsigned char* data) {
+            uint64_t word;
+            std::memcpy(&word, data, 8);
+            mix(word);
+        }
+        void update(const unsigned char* data, size_t len) {
+            if (carry_len) {
+                size_t take = std::min(len, 8 - carry_len);
+                std::memcpy(carry + carry_len, data, take);
+                carry_len += take;
+                data += take;
+                len -= take;
+                if (carry_len < 8) {
+                    return;
+                }
+                mix_bytes(carry);
+                carry_len = 0;
+            }
+            for (; len >= 8; data += 8, len -= 8) {
+                mix_bytes(data);
+            }
+            std::memcpy(carry, data, len);
+            carry_len = len;
+        }
+        size_t finish(size_t size) {
+            if (carry_len) {
+                std::memset(carry + carry_len, 0, 8 - carry_len);
+                mix_bytes(carry);
+            }
+            mix(size);
+            uint64_t res = acc ^ (acc >> 33);
+            res *= k2;
+            return res ^ (res >> 29);
+        }
+    };
+};
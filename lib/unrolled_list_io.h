@@ -0,0 +1,231 @@
+#pragma once
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <istream>
+#include <ostream>
+#include <system_error>
+#include <type_traits>
+
+#include "unrolled_list.h"
+
+// Binary record I/O straight between a stream and node storage. Reads fill the free
+// slots of the tail and then fresh nodes, one read (or one readv iovec) per node, and
+// set `end` from the number of whole records that arrived; writes hand every node's
+// [0, end) run to the stream as is. T must be trivially copyable.
+struct unrolled_list_io {
+    template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+    static size_t read(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>&, std::istream&,
+                       size_t);
+    template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+    static size_t read(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>&, int, size_t);
+    template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+    static size_t write(const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>&,
+                        std::ostream&);
+    template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+    static size_t write(const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>&, int);
+
+   private:
+    // iovecs handed to one readv/writev call
+    static constexpr size_t batch = 64;
+
+    template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+    static size_t commit(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>&,
+                         node<T, NodeMaxSize>*, size_t);
+};
+
+// Appends up to `count` records read from `in`; returns how many arrived. A trailing
+// partial record is dropped.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+inline size_t read_into(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list,
+                        std::istream& in, size_t count) {
+    return unrolled_list_io::read(list, in, count);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+inline size_t read_into(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list, int fd,
+                        size_t count) {
+    return unrolled_list_io::read(list, fd, count);
+}
+// Writes every record of the list; returns how many were written in full.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+inline size_t write_from(const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list,
+                         std::ostream& out) {
+    return unrolled_list_io::write(list, out);
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+inline size_t write_from(const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list,
+                         int fd) {
+    return unrolled_list_io::write(list, fd);
+}
+
+// Accounts `records` new records in `target`: the tail grows in place, a fresh node
+// is linked after it, and a fresh node that got nothing goes back to the cache.
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+size_t unrolled_list_io::commit(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list,
+                                node<T, NodeMaxSize>* target, size_t records) {
+    if (target == list.tail) {
+        target->end += records;
+    } else if (records == 0) {
+        list.recycle_node(target);
+        return 0;
+    } else {
+        target->end = records;
+        list.tail->link_forward(target);
+        list.tail = target;
+        ++list.node_capacity;
+        list.number_tail();
+    }
+    list.capacity += records;
+    return records;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+size_t unrolled_list_io::read(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list,
+                              std::istream& in, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "records are read as raw bytes");
+    list.seal_gap();
+    size_t total = 0;
+    while (total < count) {
+        node<T, NodeMaxSize>* target = list.tail;
+        if (target->end == NodeMaxSize) {
+            target = list.create_node();
+        }
+        size_t wanted = std::min(NodeMaxSize - target->end, count - total);
+        size_t got = 0;
+        try {
+            in.read(reinterpret_cast<char*>(&target->at(target->end)), wanted * sizeof(T));
+            got = static_cast<size_t>(in.gcount()) / sizeof(T);
+        } catch (...) {
+            commit(list, target, 0);
+            throw;
+        }
+        total += commit(list, target, got);
+        if (got < wanted) {
+            break;
+        }
+    }
+    return total;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+size_t unrolled_list_io::read(unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list,
+                              int fd, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "records are read as raw bytes");
+    list.seal_gap();
+    size_t total = 0;
+    bool finished = false;
+    while (total < count && !finished) {
+        node<T, NodeMaxSize>* targets[batch];
+        iovec segments[batch];
+        size_t lengths[batch];
+        size_t used = 0;
+        size_t left = count - total;
+        try {
+            while (used < batch && left > 0) {
+                node<T, NodeMaxSize>* target = list.tail;
+                if (used > 0 || target->end == NodeMaxSize) {
+                    target = list.create_node();
+                }
+                size_t records = std::min(NodeMaxSize - target->end, left);
+                targets[used] = target;
+                lengths[used] = records * sizeof(T);
+                segments[used].iov_base = &target->at(target->end);
+                segments[used].iov_len = lengths[used];
+                left -= records;
+                ++used;
+            }
+        } catch (...) {
+            for (size_t i = 0; i < used; ++i) {
+                commit(list, targets[i], 0);
+            }
+            throw;
+        }
+
+        int error = 0;
+        size_t first = 0;
+        while (first < used) {
+            ssize_t got = ::readv(fd, segments + first, static_cast<int>(used - first));
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                error = got < 0 ? errno : 0;
+                finished = true;
+                break;
+            }
+            for (size_t bytes = static_cast<size_t>(got); bytes > 0;) {
+                size_t step = std::min(bytes, segments[first].iov_len);
+                segments[first].iov_base = static_cast<char*>(segments[first].iov_base) + step;
+                segments[first].iov_len -= step;
+                bytes -= step;
+                if (segments[first].iov_len == 0) {
+                    ++first;
+                }
+            }
+        }
+        for (size_t i = 0; i < used; ++i) {
+            total += commit(list, targets[i], (lengths[i] - segments[i].iov_len) / sizeof(T));
+        }
+        if (error) {
+            throw std::system_error(error, std::generic_category(), "readv");
+        }
+    }
+    return total;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+size_t unrolled_list_io::write(
+    const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list, std::ostream& out) {
+    static_assert(std::is_trivially_copyable_v<T>, "records are written as raw bytes");
+    size_t total = 0;
+    for (const node<T, NodeMaxSize>* temp = list.head; temp && out; temp = temp->next) {
+        if (temp->end == 0) {
+            continue;
+        }
+        out.write(reinterpret_cast<const char*>(&temp->at(0)), temp->end * sizeof(T));
+        if (out) {
+            total += temp->end;
+        }
+    }
+    return total;
+}
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation>
+size_t unrolled_list_io::write(
+    const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list, int fd) {
+    static_assert(std::is_trivially_copyable_v<T>, "records are written as raw bytes");
+    size_t written = 0;
+    const node<T, NodeMaxSize>* temp = list.head;
+    while (temp) {
+        iovec segments[batch];
+        size_t used = 0;
+        for (; temp && used < batch; temp = temp->next) {
+            if (temp->end > 0) {
+                segments[used].iov_base = const_cast<T*>(&temp->at(0));
+                segments[used].iov_len = temp->end * sizeof(T);
+                ++used;
+            }
+        }
+        size_t first = 0;
+        while (first < used) {
+            ssize_t put = ::writev(fd, segments + first, static_cast<int>(used - first));
+            if (put < 0 && errno == EINTR) {
+                continue;
+            }
+            if (put < 0) {
+                throw std::system_error(errno, std::generic_category(), "writev");
+            }
+            written += static_cast<size_t>(put);
+            for (size_t bytes = static_cast<size_t>(put); bytes > 0;) {
+                size_t step = std::min(bytes, segments[first].iov_len);
+                segments[first].iov_base = static_cast<char*>(segments[first].iov_base) + step;
+                segments[first].iov_len -= step;
+                bytes -= step;
+                if (segments[first].iov_len == 0) {
+                    ++first;
+                }
+            }
+        }
+    }
+    return written / sizeof(T);
+}
@@ -0,0 +1,200 @@
+#pragma once
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <ostream>
+
+// Operations an instrumentation policy is told about. `split` is the thread_forward of
+// a full node during insert; `node_alloc` / `node_free` cover taking a node from the
+// spare cache or the allocator and handing it back.
+enum class list_op { push, pop, insert, erase, split, node_alloc, node_free };
+
+// The default policy: its scope is an empty literal type, so an unrolled_list built
+// with it compiles to exactly the code it had before instrumentation existed.
+struct no_instrumentation {
+    struct scope {
+        inline constexpr explicit scope(list_op) noexcept {}
+    };
+};
+
+// Counts per operation, one power-of-two latency bucket per bit of the tick count.
+struct latency_snapshot {
+    static constexpr size_t ops = 7;
+    static constexpr size_t buckets = 64;
+
+    uint64_t counts[ops][buckets] = {};
+
+    uint64_t total(list_op op) const;
+    // upper bound (in ticks) of the bucket holding the q-th quantile, 0 < q <= 1
+    uint64_t quantile(list_op op, double q) const;
+    void write_text(std::ostream& out) const;
+    void write_json(std::ostream& out) const;
+
+    static const char* name(list_op op);
+};
+
+// Records the latency of every operation into histograms. Each thread writes its own
+// block of buckets with relaxed single-writer stores, so recording takes no lock and no
+// read-modify-write; blocks are pushed once onto a global list that snapshot() sums up.
+// Ticks are TSC cycles on x86 and steady_clock nanoseconds elsewhere.
+struct latency_histograms {
+#if defined(__x86_64__) || defined(__i386__)
+    static constexpr const char* unit = "cycles";
+#else
+    static constexpr const char* unit = "ns";
+#endif
+
+    class scope {
+       public:
+        inline constexpr explicit scope(list_op op) noexcept : op(op), start(0) {
+            if !consteval {
+                start = now();
+            }
+        }
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+        inline constexpr ~scope() {
+            if !consteval {
+                record(op, now() - start);
+            }
+        }
+
+       private:
+        list_op op;
+        uint64_t start;
+    };
+
+    static inline uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+    static inline void record(list_op op, uint64_t ticks) noexcept {
+        block* mine = local();
+        if (!mine) {
+            return;
+        }
+        size_t index = std::min<size_t>(std::bit_width(ticks), latency_snapshot::buckets - 1);
+        std::atomic<uint64_t>& bucket = mine->counts[static_cast<size_t>(op)][index];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    // Sums the blocks of every thread that has recorded so far. Counts of threads that
+    // are recording meanwhile may be off by the operations in flight.
+    static latency_snapshot snapshot();
+    static void reset() noexcept;
+
+   private:
+    struct block {
+        std::atomic<uint64_t> counts[latency_snapshot::ops][latency_snapshot::buckets] = {};
+        block* next = nullptr;
+    };
+
+    // Blocks outlive their threads: a thread that exits keeps its counts in the snapshot.
+    static inline std::atomic<block*> blocks{nullptr};
+
+    // null only if the thread's block could not be allocated; its samples are dropped
+    static block* local() noexcept;
+};
+
+inline latency_histograms::block* latency_histograms::local() noexcept {
+    thread_local block* mine = nullptr;
+    if (!mine) {
+        mine = new (std::nothrow) block;
+        if (!mine) {
+            return nullptr;
+        }
+        mine->next = blocks.load(std::memory_order_relaxed);
+        while (!blocks.compare_exchange_weak(mine->next, mine, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+    }
+    return mine;
+}
+inline latency_snapshot latency_histograms::snapshot() {
+    latency_snapshot res;
+    for (block* temp = blocks.load(std::memory_order_acquire); temp; temp = temp->next) {
+        for (size_t op = 0; op < latency_snapshot::ops; ++op) {
+            for (size_t i = 0; i < latency_snapshot::buckets; ++i) {
+                res.counts[op][i] += temp->counts[op][i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return res;
+}
+inline void latency_histograms::reset() noexcept {
+    for (block* temp = blocks.load(std::memory_order_acquire); temp; temp = temp->next) {
+        for (size_t op = 0; op < latency_snapshot::ops; ++op) {
+            for (size_t i = 0; i < latency_snapshot::buckets; ++i) {
+                temp->counts[op][i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+inline const char* latency_snapshot::name(list_op op) {
+    static constexpr const char* names[ops] = {"push",  "pop",        "insert",   "erase",
+                                               "split", "node_alloc", "node_free"};
+    return names[static_cast<size_t>(op)];
+}
+inline uint64_t latency_snapshot::total(list_op op) const {
+    uint64_t res = 0;
+    for (uint64_t count : counts[static_cast<size_t>(op)]) {
+        res += count;
+    }
+    return res;
+}
+inline uint64_t latency_snapshot::quantile(list_op op, double q) const {
+    uint64_t all = total(op);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets; ++i) {
+        seen += counts[static_cast<size_t>(op)][i];
+        if (seen > 0 && seen >= q * all) {
+            return i == 0 ? 0 : (uint64_t(1) << i) - 1;
+        }
+    }
+    return 0;
+}
+// One line per operation that was seen: count and p50 / p99 / max bucket bounds.
+inline void latency_snapshot::write_text(std::ostream& out) const {
+    for (size_t op = 0; op < ops; ++op) {
+        list_op temp = static_cast<list_op>(op);
+        if (total(temp) == 0) {
+            continue;
+        }
+        out << name(temp) << " count=" << total(temp) << " p50<=" << quantile(temp, 0.5)
+            << " p99<=" << quantile(temp, 0.99) << " max<=" << quantile(temp, 1.0) << " "
+            << latency_histograms::unit << '\n';
+    }
+}
+// {"unit": ..., "ops": {"push": {"count": n, "buckets": [[upper bound, count], ...]}, ...}}
+// with only the non-empty buckets listed.
+inline void latency_snapshot::write_json(std::ostream& out) const {
+    out << "{\"unit\":\"" << latency_histograms::unit << "\",\"ops\":{";
+    for (size_t op = 0; op < ops; ++op) {
+        list_op temp = static_cast<list_op>(op);
+        out << (op ? "," : "") << '"' << name(temp) << "\":{\"count\":" << total(temp)
+            << ",\"buckets\":[";
+        bool first = true;
+        for (size_t i = 0; i < buckets; ++i) {
+            if (counts[op][i] == 0) {
+                continue;
+            }
+            out << (first ? "" : ",") << '[' << (i == 0 ? 0 : (uint64_t(1) << i) - 1) << ','
+                << counts[op][i] << ']';
+            first = false;
+        }
+        out << "]}";
+    }
+    out << "}}";
+}
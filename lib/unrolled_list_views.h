@@ -0,0 +1,59 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "unrolled_list.h"
+
+// Pipeline stages that materialise straight into a new unrolled_list:
+//
+//     auto out = list | filter_into(is_valid) | transform_into(normalize);
+//
+// Each stage reads its source lazily through a std::views adaptor and writes the result
+// node by node with append_range, so no intermediate std::vector is built in between.
+// The result keeps the source's NodeMaxSize and allocator (rebound to the new type).
+
+template <typename Pred>
+struct filter_into_fn {
+    Pred pred;
+};
+
+template <typename Func>
+struct transform_into_fn {
+    Func func;
+};
+
+template <typename Pred>
+inline filter_into_fn<Pred> filter_into(Pred pred) {
+    return {std::move(pred)};
+}
+
+template <typename Func>
+inline transform_into_fn<Func> transform_into(Func func) {
+    return {std::move(func)};
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation,
+          typename Pred>
+unrolled_list<T, NodeMaxSize, Allocator, Instrumentation> operator|(
+    const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list,
+    filter_into_fn<Pred> stage) {
+    unrolled_list<T, NodeMaxSize, Allocator, Instrumentation> res(list.get_allocator());
+    res.append_range(list | std::views::filter(std::ref(stage.pred)));
+    return res;
+}
+
+template <typename T, size_t NodeMaxSize, typename Allocator, typename Instrumentation,
+          typename Func>
+auto operator|(const unrolled_list<T, NodeMaxSize, Allocator, Instrumentation>& list,
+               transform_into_fn<Func> stage) {
+    typedef std::remove_cvref_t<std::invoke_result_t<Func&, const T&>> result_type;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<result_type>
+        result_allocator;
+    unrolled_list<result_type, NodeMaxSize, result_allocator, Instrumentation> res(
+        result_allocator(list.get_allocator()));
+    res.append_range(list | std::views::transform(std::ref(stage.func)));
+    return res;
+}
@@ -0,0 +1,93 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <iterator>
+#include <random>
+#include <string>
+
+/*
+    pop_front_n / pop_back_n снимают элементы пачкой: целые ноды уходят за один
+    шаг, а результат совпадает с std::deque, в том числе когда просят больше,
+    чем есть в списке.
+*/
+
+TEST(BulkEraseTest, popNFromBothEnds) {
+    unrolled_list<std::string, 8> list;
+    std::deque<std::string> model;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(std::to_string(i));
+        model.push_back(std::to_string(i));
+    }
+    std::mt19937 gen(42);
+    while (!model.empty()) {
+        size_t count = gen() % 50;
+        if (gen() % 2) {
+            list.pop_front_n(count);
+            model.erase(model.begin(), model.begin() + std::min(count, model.size()));
+        } else {
+            list.pop_back_n(count);
+            model.erase(model.end() - std::min(count, model.size()), model.end());
+        }
+        ASSERT_EQ(list.size(), model.size());
+        ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+        ASSERT_LE(list.max_size(), (model.size() / 8 + 2) * 8);
+    }
+    list.pop_front_n(5);
+    ASSERT_TRUE(list.empty());
+    list.push_back("x");
+    ASSERT_THAT(list, ::testing::ElementsAre("x"));
+}
+
+/*
+    Удаление префикса в миллион элементов освобождает ноды целиком: число
+    нод падает до числа нод оставшегося хвоста.
+*/
+
+TEST(BulkEraseTest, dropLongPrefix) {
+    unrolled_list<int, 64> list;
+    for (int i = 0; i < 1100000; ++i) {
+        list.push_back(i);
+    }
+    list.pop_front_n(1000000);
+    ASSERT_EQ(list.size(), 100000);
+    ASSERT_EQ(list.front(), 1000000);
+    ASSERT_EQ(list.back(), 1099999);
+    ASSERT_LE(list.max_size(), 100000 + 2 * 64);
+}
+
+/*
+    erase(first, last) и erase(pos) на случайных диапазонах внутри одной ноды,
+    через несколько нод и до конца списка совпадают с std::deque, а
+    возвращённый итератор указывает на элемент после удалённых.
+*/
+
+TEST(BulkEraseTest, eraseRanges) {
+    for (int seed = 0; seed < 20; ++seed) {
+        unrolled_list<int, 6> list;
+        std::deque<int> model;
+        for (int i = 0; i < 300; ++i) {
+            list.push_back(i);
+            model.push_back(i);
+        }
+        std::mt19937 gen(seed);
+        while (!model.empty()) {
+            size_t from = gen() % model.size();
+            size_t to = from + gen() % std::min<size_t>(model.size() - from + 1, 25);
+            auto it = list.erase(std::next(list.cbegin(), from), std::next(list.cbegin(), to));
+            auto model_it = model.erase(model.begin() + from, model.begin() + to);
+            ASSERT_EQ(std::distance(list.begin(), it), std::distance(model.begin(), model_it));
+            ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+            if (!model.empty() && gen() % 3 == 0) {
+                size_t position = gen() % model.size();
+                list.erase(std::next(list.begin(), position));
+                model.erase(model.begin() + position);
+            }
+            ASSERT_EQ(list.size(), model.size());
+        }
+        ASSERT_EQ(list.begin(), list.end());
+        ASSERT_EQ(list.max_size(), 6);
+    }
+}
@@ -0,0 +1,136 @@
+#include <chunk_tree.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+    Вставки и удаления по индексу в случайные позиции сверяются с std::vector,
+    итерация по цепочке листьев должна давать ту же последовательность.
+*/
+
+TEST(ChunkTree, randomPositionalEdits) {
+    chunk_tree<int, 8> tree;
+    std::vector<int> model;
+    std::mt19937 gen(3);
+    for (int i = 0; i < 20000; ++i) {
+        if (model.empty() || gen() % 3 != 0) {
+            size_t position = gen() % (model.size() + 1);
+            tree.insert(position, i);
+            model.insert(model.begin() + position, i);
+        } else {
+            size_t position = gen() % model.size();
+            tree.erase(position);
+            model.erase(model.begin() + position);
+        }
+    }
+
+    ASSERT_EQ(tree.size(), model.size());
+    ASSERT_THAT(tree, ::testing::ElementsAreArray(model));
+    for (size_t i = 0; i < model.size(); i += 97) {
+        ASSERT_EQ(tree[i], model[i]);
+        ASSERT_EQ(*tree.nth(i), model[i]);
+    }
+    ASSERT_LE(tree.depth(), 5);
+
+    while (!model.empty()) {
+        tree.pop_front();
+        model.erase(model.begin());
+    }
+    ASSERT_TRUE(tree.empty());
+    ASSERT_EQ(tree.begin(), tree.end());
+}
+
+/*
+    split и concat в случайных местах сохраняют порядок элементов и высоту дерева.
+*/
+
+TEST(ChunkTree, splitAndConcat) {
+    chunk_tree<std::string, 4> tree;
+    std::vector<std::string> model;
+    for (int i = 0; i < 5000; ++i) {
+        tree.push_back(std::to_string(i));
+        model.push_back(std::to_string(i));
+    }
+
+    std::mt19937 gen(11);
+    for (int i = 0; i < 300; ++i) {
+        size_t cut = gen() % (model.size() + 1);
+        chunk_tree<std::string, 4> tail = tree.split(cut);
+        ASSERT_EQ(tree.size(), cut);
+        ASSERT_EQ(tail.size(), model.size() - cut);
+        if (i % 2 == 0) {
+            tail.concat(std::move(tree));
+            tree = std::move(tail);
+            std::rotate(model.begin(), model.begin() + cut, model.end());
+        } else {
+            tree.concat(std::move(tail));
+        }
+        ASSERT_TRUE(tail.empty());
+    }
+
+    ASSERT_THAT(tree, ::testing::ElementsAreArray(model));
+    ASSERT_LE(tree.depth(), 6);
+}
+
+/*
+    Склейка деревьев очень разной высоты в обе стороны.
+*/
+
+TEST(ChunkTree, concatUnevenHeights) {
+    chunk_tree<int, 4> big;
+    chunk_tree<int, 4> small;
+    std::vector<int> model;
+    for (int i = 0; i < 3000; ++i) {
+        big.push_back(i);
+    }
+    small.push_back(-1);
+    small.push_back(-2);
+
+    small.concat(std::move(big));
+    model = {-1, -2};
+    for (int i = 0; i < 3000; ++i) {
+        model.push_back(i);
+    }
+    chunk_tree<int, 4> tiny;
+    tiny.push_back(7);
+    small.concat(std::move(tiny));
+    model.push_back(7);
+
+    ASSERT_THAT(small, ::testing::ElementsAreArray(model));
+    ASSERT_EQ(small[2], 0);
+    ASSERT_EQ(small[model.size() - 1], 7);
+}
+
+/*
+    Листья из одного элемента: при разбиении полного листа вставка попадает
+    в ту половину, где есть место, в каком бы месте листа она ни была.
+*/
+
+TEST(ChunkTree, singleElementLeaves) {
+    chunk_tree<std::string, 1> tree;
+    std::vector<std::string> model;
+    std::mt19937 gen(32);
+    for (int i = 0; i < 2000; ++i) {
+        std::string value(20, 'a' + i % 26);
+        if (model.empty() || gen() % 4 != 0) {
+            size_t position = i < 50 ? model.size() : gen() % (model.size() + 1);
+            tree.insert(position, value);
+            model.insert(model.begin() + position, value);
+        } else {
+            size_t position = gen() % model.size();
+            tree.erase(position);
+            model.erase(model.begin() + position);
+        }
+    }
+    ASSERT_THAT(tree, ::testing::ElementsAreArray(model));
+
+    size_t cut = model.size() / 3;
+    chunk_tree<std::string, 1> tail = tree.split(cut);
+    tail.concat(std::move(tree));
+    std::rotate(model.begin(), model.begin() + cut, model.end());
+    ASSERT_THAT(tail, ::testing::ElementsAreArray(model));
+}
@@ -0,0 +1,128 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+typedef std::hash<unrolled_list<int, 6>> int_hash;
+typedef std::hash<unrolled_list<std::string, 6>> string_hash;
+
+template <typename T>
+unrolled_list<T, 6> from_front(const std::vector<T>& values) {
+    unrolled_list<T, 6> list;
+    for (size_t i = values.size(); i > 0; --i) {
+        list.push_front(values[i - 1]);
+    }
+    return list;
+}
+
+template <typename T>
+unrolled_list<T, 6> from_back(const std::vector<T>& values) {
+    unrolled_list<T, 6> list;
+    for (const T& value : values) {
+        list.push_back(value);
+    }
+    return list;
+}
+
+/*
+    Списки с одинаковыми элементами, но разной раскладкой по нодам (заполнение
+    с головы и с хвоста), равны и имеют одинаковый хэш; отличие в одном элементе
+    или в длине делает их неравными.
+*/
+
+TEST(CompareTest, equalityIgnoresNodeLayout) {
+    std::vector<int> values;
+    for (int i = 0; i < 101; ++i) {
+        values.push_back(i * 31 % 17);
+    }
+    auto left = from_front(values);
+    auto right = from_back(values);
+    ASSERT_TRUE(left == right);
+    ASSERT_FALSE(left != right);
+    ASSERT_EQ(int_hash()(left), int_hash()(right));
+
+    right.pop_back();
+    ASSERT_TRUE(left != right);
+    right.push_back(-1);
+    ASSERT_TRUE(left != right);
+    ASSERT_NE(int_hash()(left), int_hash()(right));
+
+    std::vector<std::string> words = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta",
+                                      "eta",   "theta", "iota", "kappa", "lambda"};
+    auto left_words = from_front(words);
+    auto right_words = from_back(words);
+    ASSERT_TRUE(left_words == right_words);
+    ASSERT_EQ(string_hash()(left_words), string_hash()(right_words));
+}
+
+/*
+    <=> совпадает с лексикографическим сравнением std::vector, включая случай,
+    когда один список — префикс другого.
+*/
+
+TEST(CompareTest, threeWayMatchesVector) {
+    std::vector<std::vector<int>> samples = {
+        {}, {1}, {1, 2, 3}, {1, 2, 3, 4, 5, 6, 7, 8}, {1, 2, 4}, {0, 9, 9, 9, 9, 9, 9, 9, 9}};
+    for (const auto& a : samples) {
+        for (const auto& b : samples) {
+            auto left = from_front(a);
+            auto right = from_back(b);
+            ASSERT_EQ(left <=> right, a <=> b);
+            ASSERT_EQ(left < right, a < b);
+            ASSERT_EQ(left == right, a == b);
+        }
+    }
+}
+
+/*
+    Хэш годится для дедупликации в unordered_set.
+*/
+
+TEST(CompareTest, hashDeduplicates) {
+    std::unordered_set<unrolled_list<int, 6>> seen;
+    for (int round = 0; round < 3; ++round) {
+        for (int len = 0; len < 20; ++len) {
+            std::vector<int> values(len);
+            for (int i = 0; i < len; ++i) {
+                values[i] = i;
+            }
+            seen.insert(round % 2 ? from_front(values) : from_back(values));
+        }
+    }
+    ASSERT_EQ(seen.size(), 20);
+}
+
+/*
+    Тип без паддинга со своим operator== и std::hash сравнивается и хэшируется
+    через них, а не побайтно: элементы, различающиеся только в tag, равны.
+*/
+
+struct Keyed {
+    int id;
+    int tag;
+
+    bool operator==(const Keyed& other) const { return id == other.id; }
+};
+
+template <>
+struct std::hash<Keyed> {
+    size_t operator()(const Keyed& value) const { return std::hash<int>()(value.id); }
+};
+
+typedef std::hash<unrolled_list<Keyed, 6>> keyed_hash;
+
+TEST(CompareTest, customEqualityOfPaddingFreeType) {
+    auto left = from_back(std::vector<Keyed>{{1, 1}, {2, 5}});
+    auto right = from_front(std::vector<Keyed>{{1, 2}, {2, 6}});
+    ASSERT_TRUE(left == right);
+    ASSERT_EQ(keyed_hash()(left), keyed_hash()(right));
+    right.push_back({3, 3});
+    ASSERT_FALSE(left == right);
+
+    static_assert(noexcept(int_hash()(std::declval<const unrolled_list<int, 6>&>())));
+    static_assert(!noexcept(keyed_hash()(left)));
+}
@@ -0,0 +1,109 @@
+#include <compressed_unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <list>
+#include <random>
+
+/*
+    Монотонно растущие метки времени с небольшим шагом должны сжиматься
+    как минимум в 3 раза относительно 8 байт на элемент.
+*/
+
+TEST(CompressedUnrolledList, monotonicTimestamps) {
+    compressed_unrolled_list<uint64_t, 128> compressed;
+    std::list<uint64_t> std_list;
+    uint64_t timestamp = 1700000000000000ull;
+    std::mt19937_64 gen(7);
+    for (int i = 0; i < 100000; ++i) {
+        timestamp += gen() % 1000;
+        compressed.push_back(timestamp);
+        std_list.push_back(timestamp);
+    }
+
+    ASSERT_EQ(compressed.size(), std_list.size());
+    ASSERT_THAT(compressed, ::testing::ElementsAreArray(std_list));
+    ASSERT_LT(compressed.memory_usage() * 3, std_list.size() * sizeof(uint64_t));
+}
+
+/*
+    Смешанные insert / erase / push_front / pop_* на случайных значениях полной ширины.
+*/
+
+TEST(CompressedUnrolledList, mixedOperations) {
+    compressed_unrolled_list<uint64_t, 16> compressed;
+    std::list<uint64_t> std_list;
+    std::mt19937_64 gen(42);
+    for (int i = 0; i < 3000; ++i) {
+        uint64_t value = i % 5 == 0 ? gen() : gen() % 100;
+        if (i % 4 == 0) {
+            compressed.push_front(value);
+            std_list.push_front(value);
+        } else if (i % 4 == 1) {
+            compressed.push_back(value);
+            std_list.push_back(value);
+        } else if (i % 4 == 2) {
+            auto std_it = std_list.begin();
+            auto compressed_it = compressed.begin();
+            std::advance(std_it, std_list.size() / 3);
+            std::advance(compressed_it, std_list.size() / 3);
+            ASSERT_EQ(*compressed.insert(compressed_it, value), value);
+            std_list.insert(std_it, value);
+        } else {
+            auto std_it = std_list.begin();
+            auto compressed_it = compressed.begin();
+            std::advance(std_it, std_list.size() / 2);
+            std::advance(compressed_it, std_list.size() / 2);
+            compressed.erase(compressed_it);
+            std_list.erase(std_it);
+        }
+    }
+    ASSERT_THAT(compressed, ::testing::ElementsAreArray(std_list));
+
+    for (int i = 0; i < 500; ++i) {
+        compressed.pop_front();
+        std_list.pop_front();
+        compressed.pop_back();
+        std_list.pop_back();
+    }
+    ASSERT_THAT(compressed, ::testing::ElementsAreArray(std_list));
+    ASSERT_EQ(compressed.front(), std_list.front());
+    ASSERT_EQ(compressed.back(), std_list.back());
+
+    compressed.clear();
+    ASSERT_TRUE(compressed.empty());
+    compressed.push_back(5);
+    ASSERT_EQ(compressed.front(), 5);
+}
+
+/*
+    for_each_segment отдаёт раскодированные ноды целиком, в порядке списка.
+*/
+
+TEST(CompressedUnrolledList, segmentScan) {
+    compressed_unrolled_list<uint32_t, 64> compressed;
+    uint64_t expected = 0;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        uint32_t value = i * 3 + (i % 200 == 0 ? 70000 : 0);
+        compressed.push_back(value);
+        expected += value;
+    }
+    uint64_t sum = 0;
+    uint32_t previous = 0;
+    size_t elements = 0;
+    compressed.for_each_segment([&](std::span<const uint32_t> segment) {
+        ASSERT_LE(segment.size(), 64);
+        for (uint32_t value : segment) {
+            sum += value;
+            if (value % 3 == 0 && elements > 0) {
+                ASSERT_GT(value, previous);
+            }
+            previous = value % 3 == 0 ? value : previous;
+            ++elements;
+        }
+    });
+    ASSERT_EQ(elements, 10000);
+    ASSERT_EQ(sum, expected);
+}
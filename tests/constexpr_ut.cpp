@@ -0,0 +1,69 @@
+#include <flat_view.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <numeric>
+
+namespace {
+
+constexpr int squares_sum(int n) {
+    unrolled_list<int, 4> list;
+    for (int i = 0; i < n; ++i) {
+        if (i % 2 == 0) {
+            list.push_back(i * i);
+        } else {
+            list.push_front(i * i);
+        }
+    }
+    list.pop_front();
+    list.pop_back();
+    int sum = 0;
+    for (int value : list) {
+        sum += value;
+    }
+    return sum;
+}
+
+constexpr auto primes = flatten<[] {
+    unrolled_list<int, 8> list;
+    for (int candidate = 2; list.size() < 40; ++candidate) {
+        bool prime = true;
+        for (int divisor : list) {
+            if (candidate % divisor == 0) {
+                prime = false;
+                break;
+            }
+        }
+        if (prime) {
+            list.push_back(candidate);
+        }
+    }
+    return list;
+}>();
+
+}  // namespace
+
+/*
+    Список целиком работает в constant evaluation: push/pop с обоих концов,
+    разбиение узлов и итерация.
+*/
+
+TEST(ConstexprUnrolledList, evaluatedAtCompileTime) {
+    static_assert(squares_sum(30) == 8555 - 29 * 29 - 28 * 28);
+    ASSERT_EQ(squares_sum(30), 8555 - 29 * 29 - 28 * 28);
+}
+
+/*
+    Таблица, построенная на этапе компиляции, превращается в плоский массив.
+*/
+
+TEST(ConstexprUnrolledList, flatView) {
+    static_assert(primes.size() == 40);
+    static_assert(primes[0] == 2 && primes[39] == 173);
+    ASSERT_EQ(std::accumulate(primes.begin(), primes.end(), 0), 3087);
+
+    unrolled_list<int, 4> list{1, 2, 3, 4, 5, 6};
+    auto view = flatten<6>(list);
+    ASSERT_THAT(view, ::testing::ElementsAre(1, 2, 3, 4, 5, 6));
+}
@@ -0,0 +1,160 @@
+#include <cow_unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <utility>
+
+/*
+    Снимок не копирует узлы: обе копии указывают на одни и те же элементы,
+    пока одна из них не начнёт писать.
+*/
+
+TEST(CowUnrolledList, snapshotSharesNodes) {
+    cow_unrolled_list<int, 8> list;
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(i);
+    }
+    cow_unrolled_list<int, 8> snapshot = list.snapshot();
+
+    ASSERT_EQ(&*std::as_const(list).begin(), &*std::as_const(snapshot).begin());
+    for (size_t i = 0; i < 13; ++i) {
+        ASSERT_TRUE(list.shares_node(snapshot, i));
+    }
+    ASSERT_THAT(snapshot, ::testing::ElementsAreArray(std::as_const(list)));
+}
+
+/*
+    Запись через итератор клонирует только затронутый узел,
+    остальные узлы продолжают разделяться со снимком.
+*/
+
+TEST(CowUnrolledList, writeClonesOnlyTouchedNode) {
+    cow_unrolled_list<int, 8> list;
+    for (int i = 0; i < 64; ++i) {
+        list.push_back(i);
+    }
+    cow_unrolled_list<int, 8> snapshot = list;
+
+    auto it = list.begin();
+    std::advance(it, 20);
+    *it = -1;
+
+    ASSERT_EQ(*std::next(std::as_const(snapshot).begin(), 20), 20);
+    ASSERT_EQ(*std::next(std::as_const(list).begin(), 20), -1);
+    for (size_t i = 0; i < 8; ++i) {
+        ASSERT_EQ(list.shares_node(snapshot, i), i != 2);
+    }
+}
+
+/*
+    Снимки, сделанные по ходу случайных изменений, остаются неизменными.
+*/
+
+TEST(CowUnrolledList, snapshotsStayFrozen) {
+    cow_unrolled_list<std::string, 4> list;
+    std::list<std::string> model;
+    std::list<std::pair<cow_unrolled_list<std::string, 4>, std::list<std::string>>> history;
+    std::mt19937 gen(5);
+    for (int i = 0; i < 2000; ++i) {
+        std::string value = std::to_string(gen() % 1000);
+        size_t position = model.empty() ? 0 : gen() % model.size();
+        switch (gen() % 5) {
+            case 0:
+                list.push_front(value);
+                model.push_front(value);
+                break;
+            case 1:
+                list.push_back(value);
+                model.push_back(value);
+                break;
+            case 2:
+                list.insert(std::next(list.cbegin(), position), value);
+                model.insert(std::next(model.begin(), position), value);
+                break;
+            case 3:
+                if (!model.empty()) {
+                    list.erase(std::next(list.cbegin(), position));
+                    model.erase(std::next(model.begin(), position));
+                }
+                break;
+            default:
+                if (!model.empty()) {
+                    *std::next(list.begin(), position) = value;
+                    *std::next(model.begin(), position) = value;
+                }
+        }
+        if (i % 100 == 0) {
+            history.emplace_back(list.snapshot(), model);
+        }
+    }
+
+    ASSERT_EQ(list.size(), model.size());
+    ASSERT_THAT(std::as_const(list), ::testing::ElementsAreArray(model));
+    for (const auto& [snapshot, expected] : history) {
+        ASSERT_EQ(snapshot.size(), expected.size());
+        ASSERT_THAT(snapshot, ::testing::ElementsAreArray(expected));
+    }
+}
+
+class CowCountingResource : public std::pmr::memory_resource {
+public:
+    int Live = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++Live;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        --Live;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/*
+    polymorphic_allocator не распространяется при присваивании: список с другим
+    ресурсом копирует элементы к себе вместо того, чтобы разделять или забирать
+    чужие узлы, и после уничтожения исходного списка его ресурс пуст.
+*/
+
+TEST(CowUnrolledList, foreignAllocatorIsNotAdopted) {
+    typedef cow_unrolled_list<std::string, 4, std::pmr::polymorphic_allocator<std::string>>
+        pmr_list;
+    CowCountingResource source_resource;
+    CowCountingResource target_resource;
+    std::list<std::string> model;
+    pmr_list copied(&target_resource);
+    pmr_list moved(&target_resource);
+    {
+        pmr_list source(&source_resource);
+        for (int i = 0; i < 30; ++i) {
+            source.push_back(std::string(30, 'a' + i % 26));
+            model.push_back(std::string(30, 'a' + i % 26));
+        }
+        pmr_list snapshot = source.snapshot();
+        ASSERT_TRUE(snapshot.shares_node(source, 0));
+        pmr_list copy(source);
+        ASSERT_FALSE(copy.shares_node(source, 0));
+
+        copied = source;
+        ASSERT_FALSE(copied.shares_node(source, 0));
+        ASSERT_EQ(copied.get_allocator().resource(), &target_resource);
+
+        moved = std::move(source);
+        ASSERT_TRUE(source.empty());
+        ASSERT_EQ(moved.get_allocator().resource(), &target_resource);
+    }
+    ASSERT_EQ(source_resource.Live, 0);
+    ASSERT_THAT(std::as_const(copied), ::testing::ElementsAreArray(model));
+    ASSERT_THAT(std::as_const(moved), ::testing::ElementsAreArray(model));
+}
@@ -0,0 +1,147 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <list>
+#include <type_traits>
+
+// elements are addressed through the node's own storage, with no pointer to it kept
+// beside the nine link and bookkeeping words, and a node can't be copied byte by byte
+static_assert(sizeof(node<int, 8>) == 8 * sizeof(int) + 9 * sizeof(size_t));
+static_assert(!std::is_copy_constructible_v<node<int, 8>>);
+static_assert(!std::is_copy_assignable_v<node<int, 8>>);
+
+template<typename T>
+class DefragAllocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using size_type = size_t;
+    using is_always_equal = std::true_type;
+
+    static inline int Allocated = 0;
+    static inline int Deallocated = 0;
+
+    DefragAllocator() = default;
+
+    template<typename U>
+    DefragAllocator(const DefragAllocator<U>& other) {
+    }
+
+    pointer allocate(size_type sz) {
+        ++Allocated;
+        return reinterpret_cast<pointer>(new char[sz * sizeof(value_type)]);
+    }
+
+    void deallocate(pointer p, std::size_t n) {
+        ++Deallocated;
+        delete[] reinterpret_cast<char*>(p);
+    }
+
+    bool operator==(const DefragAllocator& other) const {
+        return true;
+    }
+};
+
+/*
+    Список заполняется вперемешку push_back / push_front / insert, чтобы ноды были
+    разбросаны по куче и заполнены наполовину.
+
+    Тест проверяет, что после defragment:
+        1. Порядок элементов не изменился
+        2. Элементы лежат в памяти по возрастанию адресов, а ноды заполнены полностью и идут подряд
+*/
+
+TEST(Defragment, keepsOrderAndPacksNodes) {
+    std::list<int> std_list;
+    unrolled_list<int, 8> unrolled_list;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3 == 0) {
+            std_list.push_front(i);
+            unrolled_list.push_front(i);
+        } else if (i % 3 == 1) {
+            std_list.push_back(i);
+            unrolled_list.push_back(i);
+        } else {
+            auto std_it = std_list.begin();
+            auto unrolled_it = unrolled_list.begin();
+            std::advance(std_it, std_list.size() / 2);
+            std::advance(unrolled_it, std_list.size() / 2);
+            std_list.insert(std_it, i);
+            unrolled_list.insert(unrolled_it, i);
+        }
+    }
+
+    unrolled_list.defragment();
+
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+    ASSERT_EQ(unrolled_list.size(), std_list.size());
+
+    const int* previous = nullptr;
+    for (const int& value : unrolled_list) {
+        if (previous) {
+            ASSERT_LT(previous, &value);
+        }
+        previous = &value;
+    }
+    const char* first = reinterpret_cast<const char*>(&unrolled_list.front());
+    const char* last = reinterpret_cast<const char*>(&unrolled_list.back());
+    ASSERT_EQ(last - first, 124 * sizeof(node<int, 8>) + 7 * sizeof(int));
+}
+
+/*
+    defragment_step с бюджетом в одну ноду должен вернуть false, пока не перенесены все ноды.
+    Между шагами список остаётся корректным, и в него можно добавлять элементы.
+*/
+
+TEST(Defragment, stepsWithinBudget) {
+    std::list<int> std_list;
+    unrolled_list<int, 4> unrolled_list;
+    for (int i = 0; i < 100; ++i) {
+        std_list.push_front(i);
+        unrolled_list.push_front(i);
+    }
+
+    ASSERT_FALSE(unrolled_list.defragment_step(1));
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+
+    unrolled_list.push_back(-1);
+    std_list.push_back(-1);
+    unrolled_list.push_front(-2);
+    std_list.push_front(-2);
+
+    size_t steps = 1;
+    while (!unrolled_list.defragment_step(1)) {
+        ++steps;
+        ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+    }
+    ASSERT_GT(steps, 10);
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+}
+
+/*
+    Тест проверяет, что старые ноды и слэб возвращаются аллокатору,
+    в том числе когда дефрагментация прервана удалением элементов.
+*/
+
+TEST(Defragment, releasesEverything) {
+    DefragAllocator<int>::Allocated = 0;
+    DefragAllocator<int>::Deallocated = 0;
+    {
+        DefragAllocator<int> allocator;
+        unrolled_list<int, 4, DefragAllocator<int>> unrolled_list(allocator);
+        for (int i = 0; i < 50; ++i) {
+            unrolled_list.push_front(i);
+        }
+        unrolled_list.defragment();
+        ASSERT_FALSE(unrolled_list.defragment_step(2));
+        for (int i = 0; i < 45; ++i) {
+            unrolled_list.pop_front();
+        }
+        ASSERT_EQ(unrolled_list.size(), 5);
+        ASSERT_EQ(unrolled_list.front(), 4);
+        ASSERT_EQ(unrolled_list.back(), 0);
+    }
+    ASSERT_EQ(DefragAllocator<int>::Allocated, DefragAllocator<int>::Deallocated);
+}
@@ -0,0 +1,134 @@
+#include <dynamic_unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <iterator>
+#include <random>
+#include <string>
+
+/*
+    Размер ноды задаётся в конструкторе: один и тот же тип работает с маленькими
+    и большими нодами, а случайная смесь операций совпадает с std::deque.
+*/
+
+TEST(DynamicUnrolledListTest, matchesDequeForAnyNodeSize) {
+    for (size_t node_size : {4, 7, 64, 1000}) {
+        dynamic_unrolled_list<std::string> list(node_size);
+        std::deque<std::string> model;
+        std::mt19937 gen(node_size);
+        for (int step = 0; step < 3000; ++step) {
+            std::string value = std::to_string(step);
+            switch (gen() % 6) {
+                case 0:
+                    list.push_back(value);
+                    model.push_back(value);
+                    break;
+                case 1:
+                    list.push_front(value);
+                    model.push_front(value);
+                    break;
+                case 2:
+                case 3: {
+                    size_t position = gen() % (model.size() + 1);
+                    auto it = list.insert(std::next(list.cbegin(), position), value);
+                    model.insert(model.begin() + position, value);
+                    ASSERT_EQ(*it, value);
+                    break;
+                }
+                case 4:
+                    if (!model.empty()) {
+                        size_t position = gen() % model.size();
+                        list.erase(std::next(list.cbegin(), position));
+                        model.erase(model.begin() + position);
+                    }
+                    break;
+                default:
+                    if (!model.empty()) {
+                        list.pop_back();
+                        model.pop_back();
+                    }
+                    if (!model.empty()) {
+                        list.pop_front();
+                        model.pop_front();
+                    }
+            }
+            ASSERT_EQ(list.size(), model.size());
+        }
+        ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+        ASSERT_TRUE(std::equal(list.rbegin(), list.rend(), model.rbegin(), model.rend()));
+        ASSERT_LE(list.nodes(), model.size() / (node_size / 2) + 2);
+    }
+}
+
+/*
+    Копирование, перемещение и clear; set_node_size меняет ёмкость только
+    для новых нод.
+*/
+
+TEST(DynamicUnrolledListTest, copyMoveAndResize) {
+    dynamic_unrolled_list<int> list(8);
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(i);
+    }
+    ASSERT_EQ(list.nodes(), 13);
+    list.set_node_size(100);
+    for (int i = 100; i < 200; ++i) {
+        list.push_back(i);
+    }
+    ASSERT_EQ(list.nodes(), 14);
+
+    dynamic_unrolled_list<int> copy(list);
+    ASSERT_THAT(copy, ::testing::ElementsAreArray(list));
+    dynamic_unrolled_list<int> moved(std::move(copy));
+    ASSERT_TRUE(copy.empty());
+    ASSERT_EQ(moved.size(), 200);
+    moved.clear();
+    ASSERT_TRUE(moved.empty());
+    ASSERT_EQ(moved.begin(), moved.end());
+    moved = list;
+    ASSERT_THAT(moved, ::testing::ElementsAreArray(list));
+}
+
+/*
+    В адаптивном режиме размер новых нод растёт, пока преобладают добавления
+    в концы, и падает, когда преобладают вставки в середину.
+*/
+
+TEST(DynamicUnrolledListTest, adaptsToOperationMix) {
+    dynamic_unrolled_list<int> list(16);
+    list.set_adaptive(true);
+    for (int i = 0; i < 20000; ++i) {
+        list.push_back(i);
+    }
+    ASSERT_EQ(list.node_size(), dynamic_unrolled_list<int>::max_node_size);
+
+    for (int i = 0; i < 20000; ++i) {
+        list.insert(std::next(list.cbegin(), list.size() / 2), i);
+    }
+    ASSERT_EQ(list.node_size(), dynamic_unrolled_list<int>::min_node_size);
+    ASSERT_EQ(list.size(), 40000);
+}
+
+/*
+    После уменьшения размера ноды большие ноды дробятся при первой вставке
+    в них, и порядок элементов сохраняется.
+*/
+
+TEST(DynamicUnrolledListTest, oversizedNodesAreRechunked) {
+    dynamic_unrolled_list<int> list(1024);
+    std::deque<int> model;
+    for (int i = 0; i < 3000; ++i) {
+        list.push_back(i);
+        model.push_back(i);
+    }
+    ASSERT_EQ(list.nodes(), 3);
+    list.set_node_size(16);
+    for (size_t position : {0, 3000, 1500, 1024, 2048, 7}) {
+        list.insert(std::next(list.cbegin(), position), -1);
+        model.insert(model.begin() + position, -1);
+        ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+    }
+    ASSERT_EQ(list.nodes(), 3000 / 8);
+}
@@ -4,6 +4,7 @@
 #include <gmock/gmock.h>
 
 #include <list>
+#include <ranges>
 
 class NodeTag {};
 
@@ -194,3 +195,61 @@ TEST_F(ExceptionSafetyTest, failesAtPushBack) {
     ASSERT_EQ(unrolled_list.begin()->Name, "first");
     ASSERT_EQ((++unrolled_list.begin())->Name, "second");
 }
+
+/*
+    Копирование объекта FailingCopy бросает собственный тип исключения,
+    когда выставлен флаг Armed.
+
+    Тест проверяет:
+        1. push_back и push_front пропускают исходное исключение, а не заменяют его
+        2. Когда крайняя нода заполнена, новая нода не остаётся в списке:
+           размер, содержимое и число нод не меняются
+*/
+
+struct CopyFailure {};
+
+struct FailingCopy {
+    static inline bool Armed = false;
+
+    FailingCopy(int value) : Value(value) {}
+
+    FailingCopy(const FailingCopy& other) : Value(other.Value) {
+        if (Armed) {
+            throw CopyFailure{};
+        }
+    }
+
+    FailingCopy(FailingCopy&&) noexcept = default;
+    FailingCopy& operator=(const FailingCopy&) = default;
+    FailingCopy& operator=(FailingCopy&&) noexcept = default;
+
+    int Value;
+};
+
+TEST_F(ExceptionSafetyTest, failedCopyLeavesListIntact) {
+    unrolled_list<FailingCopy, 4> unrolled_list;
+    for (int i = 0; i < 8; ++i) {
+        unrolled_list.push_back(FailingCopy(i));
+    }
+    FailingCopy extra(100);
+
+    FailingCopy::Armed = true;
+    ASSERT_THROW(unrolled_list.push_back(extra), CopyFailure);
+    ASSERT_THROW(unrolled_list.push_front(extra), CopyFailure);
+    FailingCopy::Armed = false;
+
+    ASSERT_EQ(unrolled_list.size(), 8);
+    ASSERT_EQ(std::ranges::distance(unrolled_list.nodes()), 2);
+    ASSERT_EQ(unrolled_list.broken_invariant(), nullptr);
+    int expected = 0;
+    for (const FailingCopy& item : unrolled_list) {
+        ASSERT_EQ(item.Value, expected++);
+    }
+
+    unrolled_list.pop_front();
+    FailingCopy::Armed = true;
+    ASSERT_THROW(unrolled_list.push_front(extra), CopyFailure);
+    FailingCopy::Armed = false;
+    ASSERT_EQ(unrolled_list.size(), 7);
+    ASSERT_EQ(unrolled_list.front().Value, 1);
+}
@@ -0,0 +1,170 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+
+/*
+    Вставки курсором: каждая следующая вставка идёт сразу за предыдущей.
+    Первая вставка в середину ноды открывает в ней дыру, остальные её
+    заполняют; результат совпадает с std::deque, в том числе после
+    расщепления заполненной ноды; close() возвращает элемент за серией.
+*/
+
+TEST(GapInsertTest, cursorInsertsMatchModel) {
+    unrolled_list<int, 16> list;
+    std::deque<int> model;
+    for (int i = 0; i < 200; ++i) {
+        list.push_back(i);
+        model.push_back(i);
+    }
+    auto cursor = list.insert_cursor(std::next(list.cbegin(), 37));
+    for (int i = 0; i < 500; ++i) {
+        cursor.insert(1000 + i);
+    }
+    auto it = cursor.close();
+    ASSERT_EQ(*it, 37);
+    ASSERT_EQ(list.index_of(it), 537);
+    ASSERT_EQ(*--it, 1499);
+    model.insert(model.begin() + 37, 500, 0);
+    for (int i = 0; i < 500; ++i) {
+        model[37 + i] = 1000 + i;
+    }
+    ASSERT_EQ(list.size(), model.size());
+    ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+}
+
+/*
+    Серии вставок курсором вперемешку с обходами, push/pop, удалениями и
+    обычными вставками; любая другая операция сначала отпускает курсор, и
+    его дыра закрывается. Строки не помещаются в SSO, так что потерянный
+    или двойной деструктор увидит ASAN.
+*/
+
+TEST(GapInsertTest, mixedOperationsMatchModel) {
+    typedef unrolled_list<std::string, 8> list_type;
+    list_type list;
+    std::deque<std::string> model;
+    std::mt19937 gen(47);
+    std::string pad(32, 'x');
+    std::optional<list_type::gap_cursor> cursor;
+    size_t cursor_pos = 0;
+    for (int step = 0; step < 3000; ++step) {
+        std::string value = pad + std::to_string(step);
+        size_t op = gen() % 8;
+        if (op < 5) {
+            cursor.reset();
+        }
+        switch (op) {
+            case 0:
+                list.push_back(value);
+                model.push_back(value);
+                break;
+            case 1:
+                list.push_front(value);
+                model.push_front(value);
+                break;
+            case 2:
+                if (!model.empty()) {
+                    size_t pos = gen() % model.size();
+                    list.erase(std::next(list.cbegin(), pos));
+                    model.erase(model.begin() + pos);
+                }
+                break;
+            case 3:
+                list.pop_back();
+                if (!model.empty()) {
+                    model.pop_back();
+                }
+                break;
+            case 4: {
+                size_t pos = gen() % (model.size() + 1);
+                auto it = list.insert(std::next(list.begin(), pos), value);
+                model.insert(model.begin() + pos, value);
+                ASSERT_EQ(*it, value);
+                if (pos + 1 < model.size()) {
+                    ASSERT_EQ(*++it, model[pos + 1]);
+                }
+                break;
+            }
+            default:
+                if (!cursor) {
+                    cursor_pos = gen() % (model.size() + 1);
+                    cursor.emplace(list.insert_cursor(std::next(list.cbegin(), cursor_pos)));
+                }
+                cursor->insert(value);
+                model.insert(model.begin() + cursor_pos, value);
+                ++cursor_pos;
+        }
+        if (step % 50 == 0) {
+            cursor.reset();
+            ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+        }
+    }
+    cursor.reset();
+    ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+    list_type copy(list);
+    ASSERT_EQ(copy, list);
+}
+
+/*
+    Обычная вставка в середину ноды дыру не открывает: итератор, который
+    она вернула, можно двигать в обе стороны, а --end() указывает на
+    последний элемент. То же после серии вставок курсором.
+*/
+
+TEST(GapInsertTest, iteratorsStepAcrossInserts) {
+    unrolled_list<std::string, 8> list;
+    for (int i = 0; i < 4; ++i) {
+        list.push_back(std::string(40, 'a' + i));
+    }
+    std::string s(40, 's');
+    auto r = list.insert(++list.begin(), s);
+    ASSERT_EQ(*++r, std::string(40, 'b'));
+    ASSERT_EQ(*--list.end(), std::string(40, 'd'));
+
+    auto cursor = list.insert_cursor(std::next(list.cbegin(), 2));
+    cursor.insert(std::string(40, 'x'));
+    cursor.insert(std::string(40, 'y'));
+    auto it = cursor.close();
+    ASSERT_EQ(*it, std::string(40, 'b'));
+    ASSERT_EQ(*--it, std::string(40, 'y'));
+    ASSERT_EQ(*--list.end(), std::string(40, 'd'));
+    ASSERT_EQ(*list.rbegin(), std::string(40, 'd'));
+    ASSERT_THAT(list, ::testing::ElementsAre(std::string(40, 'a'), s, std::string(40, 'x'),
+                                             std::string(40, 'y'), std::string(40, 'b'),
+                                             std::string(40, 'c'), std::string(40, 'd')));
+}
+
+/*
+    Курсор закрывает дыру, когда его разрушают; перемещённый курсор
+    продолжает серию, а неконстантный доступ к списку посреди серии
+    закрывает дыру, не ломая курсор. Список затем корректно переносится.
+*/
+
+TEST(GapInsertTest, cursorMoveAndDestroy) {
+    unrolled_list<std::string, 8> list;
+    for (int i = 0; i < 20; ++i) {
+        list.push_back(std::string(40, 'a' + i));
+    }
+    {
+        auto cursor = list.insert_cursor(std::next(list.cbegin(), 3));
+        cursor.insert(std::string(40, 'z'));
+        auto moved = std::move(cursor);
+        moved.insert(std::string(40, 'y'));
+        ASSERT_EQ(list.front(), std::string(40, 'a'));
+        moved.insert(std::string(40, 'x'));
+    }
+    ASSERT_EQ(list.broken_invariant(), nullptr);
+    unrolled_list<std::string, 8> moved(std::move(list));
+    ASSERT_EQ(moved.size(), 23);
+    ASSERT_EQ(*std::next(moved.begin(), 3), std::string(40, 'z'));
+    ASSERT_EQ(*std::next(moved.begin(), 5), std::string(40, 'x'));
+    ASSERT_EQ(*std::next(moved.begin(), 6), std::string(40, 'd'));
+    ASSERT_EQ(moved.back(), std::string(40, 'a' + 19));
+}
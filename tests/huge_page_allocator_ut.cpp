@@ -0,0 +1,111 @@
+#include <huge_page_allocator.h>
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <list>
+
+template<class Alloc>
+concept AllocatorRequirements = requires(Alloc alloc, std::size_t n)
+{
+    { *alloc.allocate(n) } -> std::same_as<typename Alloc::value_type&>;
+    { alloc.deallocate(alloc.allocate(n), n) };
+} && std::copy_constructible<Alloc>
+  && std::equality_comparable<Alloc>;
+
+static_assert(AllocatorRequirements<huge_page_allocator<int>>);
+// a shared default resource would be raced on by lists on different threads
+static_assert(!std::is_default_constructible_v<huge_page_allocator<int>>);
+
+/*
+    Все элементы списка должны лежать внутри регионов, замапленных ресурсом,
+    а порядок элементов совпадать с std::list.
+*/
+
+TEST(HugePageAllocator, nodesLiveInRegions) {
+    huge_page_resource resource;
+    huge_page_allocator<int> allocator(&resource);
+    unrolled_list<int, 32, huge_page_allocator<int>> unrolled_list(allocator);
+    std::list<int> std_list;
+    for (int i = 0; i < 10000; ++i) {
+        unrolled_list.push_back(i);
+        std_list.push_back(i);
+    }
+
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+    ASSERT_EQ(unrolled_list.get_allocator().get_resource(), &resource);
+    for (int& value : unrolled_list) {
+        ASSERT_TRUE(resource.owns(&value));
+    }
+    ASSERT_EQ(resource.mapped(), 16 * huge_page_resource::huge_page_size);
+}
+
+/*
+    Освобождённые ноды возвращаются во free list и переиспользуются:
+    повторное заполнение списка не должно мапить новую память.
+*/
+
+TEST(HugePageAllocator, recyclesNodes) {
+    huge_page_resource resource(huge_page_resource::huge_page_size);
+    huge_page_allocator<int> allocator(&resource);
+    unrolled_list<int, 16, huge_page_allocator<int>> unrolled_list(allocator);
+    for (int i = 0; i < 5000; ++i) {
+        unrolled_list.push_back(i);
+    }
+    size_t mapped = resource.mapped();
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 5000; ++i) {
+            unrolled_list.pop_front();
+        }
+        ASSERT_TRUE(unrolled_list.empty());
+        for (int i = 0; i < 5000; ++i) {
+            unrolled_list.push_back(i);
+        }
+    }
+    ASSERT_EQ(resource.mapped(), mapped);
+    ASSERT_EQ(unrolled_list.front(), 0);
+    ASSERT_EQ(unrolled_list.back(), 4999);
+}
+
+/*
+    Блок, которому не хватает места в регионе, получает собственный маппинг,
+    и при освобождении этот маппинг возвращается системе.
+*/
+
+TEST(HugePageAllocator, oversizedRequest) {
+    huge_page_resource resource(huge_page_resource::huge_page_size);
+    void* small = resource.allocate(64);
+    size_t mapped = resource.mapped();
+    void* block = resource.allocate(3 * huge_page_resource::huge_page_size);
+    ASSERT_TRUE(resource.owns(block));
+    ASSERT_GT(resource.mapped(), mapped);
+    resource.deallocate(block, 3 * huge_page_resource::huge_page_size);
+    ASSERT_EQ(resource.mapped(), mapped);
+    ASSERT_FALSE(resource.owns(block));
+    ASSERT_TRUE(resource.owns(small));
+}
+
+/*
+    Размеры округляются до степени двойки, поэтому сколько угодно разных
+    размеров (как у слэбов дефрагментации) переиспользуют освобождённые блоки,
+    и повторные раунды не мапят новую память.
+*/
+
+TEST(HugePageAllocator, manyDistinctSizesAreRecycled) {
+    huge_page_resource resource(huge_page_resource::huge_page_size);
+    void* blocks[100];
+    size_t mapped = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (size_t i = 0; i < 100; ++i) {
+            blocks[i] = resource.allocate(24 + i * 40 + round);
+        }
+        for (size_t i = 0; i < 100; ++i) {
+            resource.deallocate(blocks[i], 24 + i * 40 + round);
+        }
+        if (round == 0) {
+            mapped = resource.mapped();
+        }
+    }
+    ASSERT_EQ(resource.mapped(), mapped);
+}
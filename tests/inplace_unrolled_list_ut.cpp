@@ -0,0 +1,108 @@
+#include <inplace_unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <random>
+#include <string>
+
+/*
+    Все элементы лежат внутри самого объекта списка, а при исчерпании
+    пула узлов операции возвращают false вместо выделения памяти.
+*/
+
+TEST(InplaceUnrolledList, storageIsEmbedded) {
+    inplace_unrolled_list<int, 4, 8> list;
+    int pushed = 0;
+    while (list.try_push_back(pushed)) {
+        ++pushed;
+    }
+    ASSERT_EQ(pushed, 32);
+    ASSERT_EQ(list.size(), list.max_size());
+    ASSERT_EQ(list.free_nodes(), 0);
+    ASSERT_FALSE(list.try_push_front(-1));
+    ASSERT_FALSE(list.try_insert(list.begin(), -1));
+
+    const char* begin = reinterpret_cast<const char*>(&list);
+    const char* end = begin + sizeof(list);
+    for (const int& value : list) {
+        const char* address = reinterpret_cast<const char*>(&value);
+        ASSERT_TRUE(address >= begin && address < end);
+    }
+}
+
+/*
+    Случайные операции в сравнении с std::deque. Удаление возвращает
+    освободившиеся узлы в пул, поэтому список не «засоряется».
+*/
+
+TEST(InplaceUnrolledList, mixedOperations) {
+    inplace_unrolled_list<std::string, 6, 12> list;
+    std::deque<std::string> model;
+    std::mt19937 gen(9);
+    for (int i = 0; i < 20000; ++i) {
+        std::string value = std::to_string(i);
+        size_t position = model.empty() ? 0 : gen() % model.size();
+        switch (gen() % 5) {
+            case 0:
+                if (list.try_push_front(value)) {
+                    model.push_front(value);
+                }
+                break;
+            case 1:
+                if (list.try_push_back(value)) {
+                    model.push_back(value);
+                }
+                break;
+            case 2:
+                if (list.try_insert(std::next(list.begin(), position), value)) {
+                    model.insert(model.begin() + position, value);
+                }
+                break;
+            default:
+                if (!model.empty()) {
+                    list.erase(std::next(list.begin(), position));
+                    model.erase(model.begin() + position);
+                }
+        }
+        ASSERT_EQ(list.size(), model.size());
+    }
+    ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+
+    inplace_unrolled_list<std::string, 6, 12> copy(list);
+    ASSERT_THAT(copy, ::testing::ElementsAreArray(model));
+
+    while (!model.empty()) {
+        list.pop_back();
+        model.pop_back();
+    }
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.free_nodes(), 12);
+}
+
+/*
+    Узлы из одного элемента: вставка в полный узел — в начало, в конец и
+    в середину — занимает отдельный узел и не пишет в чужое хранилище.
+*/
+
+TEST(InplaceUnrolledList, singleElementNodes) {
+    inplace_unrolled_list<std::string, 1, 8> list;
+    std::deque<std::string> model;
+    ASSERT_TRUE(list.try_push_back(std::string(20, 'a')));
+    ASSERT_TRUE(list.try_push_back(std::string(20, 'b')));
+    model = {std::string(20, 'a'), std::string(20, 'b')};
+
+    ASSERT_TRUE(list.try_insert(list.end(), std::string(20, 'c')));
+    model.push_back(std::string(20, 'c'));
+    ASSERT_TRUE(list.try_insert(list.begin(), std::string(20, 'd')));
+    model.push_front(std::string(20, 'd'));
+    ASSERT_TRUE(list.try_insert(std::next(list.begin(), 2), std::string(20, 'e')));
+    model.insert(model.begin() + 2, std::string(20, 'e'));
+    ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+    ASSERT_EQ(list.free_nodes(), 3);
+
+    list.erase(std::next(list.begin(), 1));
+    model.erase(model.begin() + 1);
+    ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+}
@@ -0,0 +1,103 @@
+#include <intrusive_unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <ranges>
+
+namespace {
+
+struct Heavy {
+    static inline int Copies = 0;
+
+    explicit Heavy(int id) : id(id) {}
+    Heavy(const Heavy& other) : id(other.id) { ++Copies; }
+    Heavy& operator=(const Heavy& other) {
+        id = other.id;
+        ++Copies;
+        return *this;
+    }
+
+    int id;
+    char payload[240] = {};
+};
+
+}  // namespace
+
+static_assert(std::ranges::bidirectional_range<intrusive_unrolled_list<Heavy>>);
+static_assert(std::ranges::bidirectional_range<const intrusive_unrolled_list<Heavy>>);
+
+/*
+    Объекты живут снаружи: список хранит только указатели, ничего не копирует,
+    а изменения через итератор видны владельцу.
+*/
+
+TEST(IntrusiveUnrolledListTest, linksWithoutCopies) {
+    std::deque<Heavy> owner;
+    for (int i = 0; i < 1000; ++i) {
+        owner.emplace_back(i);
+    }
+    Heavy::Copies = 0;
+
+    intrusive_unrolled_list<Heavy, 16> list;
+    for (Heavy& obj : owner) {
+        list.push_back(obj);
+    }
+    ASSERT_EQ(Heavy::Copies, 0);
+    ASSERT_EQ(list.size(), 1000);
+    ASSERT_EQ(&list.front(), &owner.front());
+    ASSERT_EQ(&list.back(), &owner.back());
+
+    for (Heavy& obj : list) {
+        obj.id *= 2;
+    }
+    ASSERT_EQ(owner[500].id, 1000);
+
+    const auto& view = list;
+    int expected = 0;
+    for (const Heavy& obj : view) {
+        ASSERT_EQ(obj.id, expected);
+        expected += 2;
+    }
+    ASSERT_EQ(Heavy::Copies, 0);
+}
+
+/*
+    insert и erase работают с указателями в середине списка и при
+    разбиении нод; объекты после удаления из списка остаются нетронутыми.
+*/
+
+TEST(IntrusiveUnrolledListTest, insertAndErase) {
+    std::deque<Heavy> owner;
+    for (int i = 0; i < 100; ++i) {
+        owner.emplace_back(i);
+    }
+    intrusive_unrolled_list<Heavy, 4> list;
+    std::deque<Heavy*> model;
+    for (int i = 0; i < 50; ++i) {
+        list.push_back(owner[i]);
+        model.push_back(&owner[i]);
+    }
+    for (int i = 50; i < 100; ++i) {
+        size_t pos = (i * 7) % (model.size() + 1);
+        auto it = list.insert(std::next(list.cbegin(), pos), owner[i]);
+        ASSERT_EQ(&*it, &owner[i]);
+        model.insert(model.begin() + pos, &owner[i]);
+    }
+    auto it = list.erase(std::next(list.cbegin(), 10), std::next(list.cbegin(), 30));
+    model.erase(model.begin() + 10, model.begin() + 30);
+    ASSERT_EQ(&*it, model[10]);
+    list.erase(list.cbegin());
+    model.pop_front();
+    list.push_front(owner[0]);
+    model.push_front(&owner[0]);
+
+    ASSERT_EQ(list.size(), model.size());
+    ASSERT_TRUE(std::ranges::equal(list, model, {}, [](Heavy& obj) { return &obj; }, {}));
+    ASSERT_EQ(owner[15].id, 15);
+    auto last = std::prev(list.end());
+    ASSERT_EQ(&*last, model.back());
+}
@@ -0,0 +1,71 @@
+#include <unrolled_list_io.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+struct Record {
+    uint64_t timestamp;
+    uint32_t id;
+    float value;
+};
+
+/*
+    Записи, прочитанные из потока, раскладываются прямо по нодам,
+    а запись отдаёт содержимое нод как есть.
+*/
+
+TEST(UnrolledListIO, streamRoundTrip) {
+    unrolled_list<Record, 16> source;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        source.push_back(Record{1000u + i, i, i * 0.5f});
+    }
+    std::stringstream stream;
+    ASSERT_EQ(write_from(source, stream), 1000);
+
+    unrolled_list<Record, 16> target;
+    target.push_back(Record{1, 1, 1});
+    ASSERT_EQ(read_into(target, stream, 5000), 1000);
+    ASSERT_EQ(target.size(), 1001);
+    ASSERT_EQ(target.max_size(), (1001 + 15) / 16 * 16);
+
+    auto it = target.begin();
+    ASSERT_EQ(it->id, 1);
+    ++it;
+    for (uint32_t i = 0; i < 1000; ++i, ++it) {
+        ASSERT_EQ(it->timestamp, 1000u + i);
+        ASSERT_EQ(it->id, i);
+    }
+}
+
+/*
+    readv / writev через файловый дескриптор, неполная последняя запись отбрасывается.
+*/
+
+TEST(UnrolledListIO, descriptorRoundTrip) {
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    int fd = fileno(file);
+
+    unrolled_list<uint32_t, 7> source;
+    std::vector<uint32_t> model;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        source.push_front(i);
+        model.insert(model.begin(), i);
+    }
+    ASSERT_EQ(write_from(source, fd), 5000);
+    uint16_t tail = 0xabcd;
+    ASSERT_EQ(::write(fd, &tail, sizeof(tail)), sizeof(tail));
+    ASSERT_EQ(::lseek(fd, 0, SEEK_SET), 0);
+
+    unrolled_list<uint32_t, 7> target;
+    ASSERT_EQ(read_into(target, fd, 1200), 1200);
+    ASSERT_EQ(read_into(target, fd, 100000), 3800);
+    ASSERT_EQ(read_into(target, fd, 10), 0);
+    ASSERT_THAT(target, ::testing::ElementsAreArray(model));
+    std::fclose(file);
+}
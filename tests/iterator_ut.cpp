@@ -0,0 +1,73 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <iterator>
+#include <list>
+#include <vector>
+
+/*
+    Итераторы проходят список через границы нод в обе стороны: прямой и
+    обратный обход совпадают с std::vector, -- с end() возвращает последний
+    элемент, а константный итератор получается из обычного.
+*/
+
+TEST(IteratorTest, walksAcrossNodes) {
+    unrolled_list<int, 4> list;
+    std::vector<int> model;
+    for (int i = 0; i < 37; ++i) {
+        list.push_back(i);
+        model.push_back(i);
+    }
+    for (int i = 0; i < 11; ++i) {
+        list.push_front(-i);
+        model.insert(model.begin(), -i);
+    }
+
+    ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+    ASSERT_TRUE(std::equal(list.rbegin(), list.rend(), model.rbegin(), model.rend()));
+    ASSERT_TRUE(std::equal(list.crbegin(), list.crend(), model.crbegin(), model.crend()));
+
+    std::vector<int> backward;
+    auto it = list.end();
+    while (it != list.begin()) {
+        backward.push_back(*--it);
+    }
+    ASSERT_TRUE(std::equal(backward.begin(), backward.end(), model.rbegin(), model.rend()));
+
+    std::vector<int> reverse_back;
+    auto rit = list.rend();
+    while (rit != list.rbegin()) {
+        reverse_back.push_back(*--rit);
+    }
+    ASSERT_THAT(reverse_back, ::testing::ElementsAreArray(model));
+
+    unrolled_list<int, 4>::const_iterator cit = list.begin();
+    ASSERT_EQ(*cit, model.front());
+    ASSERT_EQ(list.end() - list.begin(), model.size());
+    ASSERT_EQ(list.rend() - list.rbegin(), model.size());
+    ASSERT_EQ(*(list.begin() + 17), model[17]);
+    ASSERT_EQ(*(list.end() - 5), model[model.size() - 5]);
+}
+
+/*
+    Вставка в середину полной ноды и на её границы, в том числе в хвост,
+    не ломает обход, а возвращённый итератор указывает на вставленный элемент.
+*/
+
+TEST(IteratorTest, insertIntoFullNodes) {
+    unrolled_list<int, 5> list;
+    std::list<int> model;
+    for (int i = 0; i < 500; ++i) {
+        size_t position = (i * 7) % (model.size() + 1);
+        auto model_it = std::next(model.begin(), position);
+        auto it = std::next(list.begin(), position);
+        model.insert(model_it, i);
+        it = list.insert(it, i);
+        ASSERT_EQ(*it, i);
+    }
+    ASSERT_EQ(list.size(), model.size());
+    ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+    ASSERT_TRUE(std::equal(list.rbegin(), list.rend(), model.rbegin(), model.rend()));
+}
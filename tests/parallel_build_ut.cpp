@@ -0,0 +1,83 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <stdexcept>
+#include <string>
+
+/*
+    from_parallel кладёт gen(i) на позицию i при любом числе потоков и любом
+    размере порции, все ноды, кроме последней, заполнены целиком.
+*/
+
+TEST(ParallelBuildTest, fromParallelMatchesSequential) {
+    for (size_t threads : {1, 2, 3, 8}) {
+        for (size_t grain : {1, 4, 100}) {
+            auto list = unrolled_list<size_t, 16>::from_parallel(
+                100003, [](size_t i) { return i * i; }, {threads, grain});
+            ASSERT_EQ(list.size(), 100003);
+            ASSERT_EQ(list.max_size(), (100003 + 15) / 16 * 16);
+            size_t i = 0;
+            for (size_t value : list) {
+                ASSERT_EQ(value, i * i);
+                ++i;
+            }
+            list.push_back(1);
+            list.pop_front();
+            ASSERT_EQ(list.front(), 1);
+        }
+    }
+    auto empty = unrolled_list<int>::from_parallel(0, [](size_t) { return 1; });
+    ASSERT_TRUE(empty.empty());
+}
+
+/*
+    transform_to читает источник с произвольной фрагментацией нод (в том
+    числе после вставок и удалений) и строит плотный список нового типа.
+*/
+
+TEST(ParallelBuildTest, transformToKeepsOrder) {
+    unrolled_list<int, 8> source;
+    std::deque<int> model;
+    for (int i = 0; i < 5000; ++i) {
+        source.push_back(i);
+        model.push_back(i);
+        if (i % 7 == 0) {
+            source.push_front(-i);
+            model.push_front(-i);
+        }
+    }
+    source.erase(std::next(source.cbegin(), 100), std::next(source.cbegin(), 900));
+    model.erase(model.begin() + 100, model.begin() + 900);
+
+    auto result = source.transform_to([](int value) { return std::to_string(value); },
+                                      {4, 2});
+    ASSERT_EQ(result.size(), model.size());
+    auto it = result.begin();
+    for (int value : model) {
+        ASSERT_EQ(*it, std::to_string(value));
+        ++it;
+    }
+}
+
+/*
+    Исключение из генератора в любом потоке пробрасывается наружу, а уже
+    построенные элементы и ноды освобождаются.
+*/
+
+TEST(ParallelBuildTest, exceptionUnwinds) {
+    auto build = [] {
+        return unrolled_list<std::string, 8>::from_parallel(
+            10000,
+            [](size_t i) {
+                if (i == 7777) {
+                    throw std::runtime_error("gen");
+                }
+                return std::string(40, 'x');
+            },
+            {4, 3});
+    };
+    ASSERT_THROW(build(), std::runtime_error);
+}
@@ -0,0 +1,122 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <memory_resource>
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    int Allocations = 0;
+    int Deallocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++Allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        ++Deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/*
+    Все ноды списка должны браться из буфера monotonic_buffer_resource.
+    Upstream - null_memory_resource, поэтому любая попытка выйти за буфер выбросит исключение.
+*/
+
+TEST(PmrUnrolledList, monotonicArena) {
+    alignas(std::max_align_t) std::byte buffer[1 << 14];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                              std::pmr::null_memory_resource());
+    pmr::unrolled_list<int, 16> unrolled_list(&arena);
+    for (int i = 0; i < 100; ++i) {
+        unrolled_list.push_back(i);
+        unrolled_list.push_front(-i);
+    }
+
+    ASSERT_EQ(unrolled_list.size(), 200);
+    ASSERT_EQ(unrolled_list.get_allocator().resource(), &arena);
+    for (int& value : unrolled_list) {
+        ASSERT_GE(reinterpret_cast<std::byte*>(&value), buffer);
+        ASSERT_LT(reinterpret_cast<std::byte*>(&value), buffer + sizeof(buffer));
+    }
+}
+
+/*
+    С unsynchronized_pool_resource после разрушения списка и release() вся память
+    должна вернуться в upstream.
+*/
+
+TEST(PmrUnrolledList, poolResource) {
+    CountingResource upstream;
+    {
+        std::pmr::unsynchronized_pool_resource pool(&upstream);
+        {
+            pmr::unrolled_list<int, 4> unrolled_list(&pool);
+            for (int i = 0; i < 1000; ++i) {
+                unrolled_list.push_back(i);
+            }
+            for (int i = 0; i < 500; ++i) {
+                unrolled_list.pop_front();
+            }
+            unrolled_list.defragment();
+            ASSERT_EQ(unrolled_list.front(), 500);
+            ASSERT_EQ(unrolled_list.back(), 999);
+        }
+        pool.release();
+    }
+    ASSERT_GT(upstream.Allocations, 0);
+    ASSERT_EQ(upstream.Allocations, upstream.Deallocations);
+}
+
+/*
+    Тест проверяет распространение аллокатора:
+        1. Копирование берёт ресурс из select_on_container_copy_construction (ресурс по умолчанию)
+        2. Копирование с аллокатором и перемещение сохраняют нужный ресурс
+        3. Присваивание перемещением между разными ресурсами копирует элементы в свой ресурс
+        4. swap между списками с одним ресурсом меняет содержимое
+*/
+
+TEST(PmrUnrolledList, allocatorPropagation) {
+    CountingResource first;
+    CountingResource second;
+    pmr::unrolled_list<int, 4> source(&first);
+    for (int i = 0; i < 20; ++i) {
+        source.push_back(i);
+    }
+
+    pmr::unrolled_list<int, 4> copy(source);
+    ASSERT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+    ASSERT_THAT(copy, ::testing::ElementsAreArray(source));
+
+    pmr::unrolled_list<int, 4> copy_with_allocator(source, &second);
+    ASSERT_EQ(copy_with_allocator.get_allocator().resource(), &second);
+    ASSERT_THAT(copy_with_allocator, ::testing::ElementsAreArray(source));
+
+    int allocations = first.Allocations;
+    pmr::unrolled_list<int, 4> moved(std::move(copy_with_allocator));
+    ASSERT_EQ(moved.get_allocator().resource(), &second);
+    ASSERT_EQ(moved.size(), 20);
+    ASSERT_TRUE(copy_with_allocator.empty());
+
+    pmr::unrolled_list<int, 4> target(&first);
+    target.push_back(42);
+    target = std::move(moved);
+    ASSERT_EQ(target.get_allocator().resource(), &first);
+    ASSERT_THAT(target, ::testing::ElementsAreArray(source));
+    ASSERT_GT(first.Allocations, allocations);
+
+    pmr::unrolled_list<int, 4> other(&first);
+    other.push_back(7);
+    target.swap(other);
+    ASSERT_EQ(target.size(), 1);
+    ASSERT_EQ(target.front(), 7);
+    ASSERT_THAT(other, ::testing::ElementsAreArray(source));
+}
@@ -0,0 +1,166 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+/*
+    index_of и distance совпадают с позициями в std::deque при любой смеси
+    операций: push/pop с обоих концов сохраняют нумерацию, вставки и
+    удаления в середине сбрасывают её, и следующий запрос перенумеровывает ноды.
+*/
+
+TEST(PositionsTest, indexMatchesModel) {
+    unrolled_list<int, 8> list;
+    std::deque<int> model;
+    std::mt19937 gen(7);
+    for (int step = 0; step < 4000; ++step) {
+        int value = static_cast<int>(gen() % 1000);
+        switch (gen() % 7) {
+            case 0:
+            case 1:
+                list.push_back(value);
+                model.push_back(value);
+                break;
+            case 2:
+                list.push_front(value);
+                model.push_front(value);
+                break;
+            case 3:
+                list.pop_front();
+                if (!model.empty()) {
+                    model.pop_front();
+                }
+                break;
+            case 4:
+                list.pop_back();
+                if (!model.empty()) {
+                    model.pop_back();
+                }
+                break;
+            case 5: {
+                size_t pos = model.empty() ? 0 : gen() % (model.size() + 1);
+                list.insert(std::next(list.cbegin(), pos), value);
+                model.insert(model.begin() + pos, value);
+                break;
+            }
+            default:
+                if (!model.empty()) {
+                    size_t pos = gen() % model.size();
+                    list.erase(std::next(list.cbegin(), pos));
+                    model.erase(model.begin() + pos);
+                }
+        }
+        if (step % 10 == 0) {
+            size_t pos = 0;
+            for (auto it = list.cbegin(); it != list.cend(); ++it, ++pos) {
+                ASSERT_EQ(list.index_of(it), pos);
+            }
+            ASSERT_EQ(list.index_of(list.cend()), model.size());
+            ASSERT_EQ(list.distance(list.cbegin(), list.cend()),
+                      static_cast<std::ptrdiff_t>(model.size()));
+        }
+    }
+    ASSERT_THAT(list, ::testing::ElementsAreArray(model));
+}
+
+/*
+    Итераторы в разных нодах сравниваются по номеру ноды, в одной ноде — по
+    слоту; обратные итераторы упорядочены наоборот. Нумерация переживает
+    push_front, который добавляет новую голову.
+*/
+
+TEST(PositionsTest, iteratorOrdering) {
+    unrolled_list<int, 4> list;
+    for (int i = 0; i < 40; ++i) {
+        list.push_back(i);
+    }
+    ASSERT_EQ(list.index_of(list.cend()), 40);
+    for (int i = 0; i < 9; ++i) {
+        list.push_front(-i);
+    }
+    auto first = list.begin();
+    auto middle = std::next(first, 20);
+    auto last = std::prev(list.end());
+    ASSERT_TRUE(first < middle);
+    ASSERT_TRUE(middle < last);
+    ASSERT_TRUE(last > first);
+    ASSERT_TRUE(std::next(middle) > middle);
+    ASSERT_EQ(middle <=> middle, std::strong_ordering::equal);
+    ASSERT_EQ(list.index_of(middle), 20);
+    ASSERT_EQ(list.distance(middle, last), 28);
+    ASSERT_EQ(list.distance(last, middle), -28);
+
+    auto rfirst = list.rbegin();
+    auto rlast = std::prev(list.rend());
+    ASSERT_TRUE(rfirst < rlast);
+    ASSERT_TRUE(std::next(rfirst) > rfirst);
+}
+
+/*
+    subrange возвращает sized_range: размер известен без обхода элементов,
+    а содержимое совпадает с отрезком списка.
+*/
+
+TEST(PositionsTest, sizedSubrange) {
+    unrolled_list<int, 8> list;
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(i);
+    }
+    auto part = list.subrange(std::next(list.begin(), 10), std::next(list.begin(), 35));
+    static_assert(std::ranges::sized_range<decltype(part)>);
+    ASSERT_EQ(std::ranges::size(part), 25);
+    ASSERT_EQ(part.front(), 10);
+
+    const auto& view = list;
+    auto whole = view.subrange(view.begin(), view.end());
+    static_assert(std::ranges::sized_range<decltype(whole)>);
+    ASSERT_EQ(std::ranges::size(whole), 100);
+    ASSERT_TRUE(std::ranges::equal(whole, std::views::iota(0, 100)));
+}
+
+/*
+    const index_of и distance ничего не пишут в ноды: несколько потоков
+    спрашивают позиции у общего const списка с устаревшей нумерацией и
+    получают верные ответы; refresh_positions обновляет нумерацию явно.
+*/
+
+TEST(PositionsTest, constQueriesFromManyThreads) {
+    unrolled_list<int, 8> list;
+    for (int i = 0; i < 400; ++i) {
+        list.push_back(2 * i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        list.insert(std::next(list.cbegin(), 4 * i + 1), 2 * (4 * i) + 1);
+    }
+    std::vector<int> expected(list.begin(), list.end());
+
+    const auto& view = list;
+    std::vector<int> correct(4, 0);
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < 4; ++t) {
+        readers.emplace_back([&view, &correct, t] {
+            bool ok = true;
+            size_t pos = 0;
+            for (auto it = view.begin(); it != view.end(); ++it, ++pos) {
+                ok = ok && view.index_of(it) == pos;
+                ok = ok && view.distance(it, view.end()) == std::ptrdiff_t(view.size() - pos);
+            }
+            correct[t] = ok;
+        });
+    }
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    ASSERT_THAT(correct, ::testing::Each(1));
+
+    list.refresh_positions();
+    ASSERT_EQ(view.index_of(std::next(view.begin(), 123)), 123);
+    ASSERT_EQ(*std::next(view.begin(), 123), expected[123]);
+}
@@ -61,6 +61,37 @@ TEST(UnrolledLinkedList, pushMixed) {
     ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
 }
 
+/*
+    push_front и push_back от элемента самого списка: копия снимается до
+    того, как элементы ноды сдвигаются, в том числе когда нода заполнена.
+*/
+
+TEST(UnrolledLinkedList, pushOwnElements) {
+    unrolled_list<int, 8> small{1, 2, 3};
+    small.push_front(small.back());
+    ASSERT_THAT(small, ::testing::ElementsAre(3, 1, 2, 3));
+
+    std::list<std::string> std_list;
+    unrolled_list<std::string, 4> unrolled_list;
+    for (int i = 0; i < 40; ++i) {
+        std::string value(30, 'a' + i % 26);
+        std_list.push_back(value);
+        unrolled_list.push_back(value);
+    }
+    for (int i = 0; i < 40; ++i) {
+        if (i % 2 == 0) {
+            std_list.push_front(std_list.back());
+            unrolled_list.push_front(unrolled_list.back());
+        } else {
+            std_list.push_back(std_list.front());
+            unrolled_list.push_back(unrolled_list.front());
+        }
+        std_list.push_front(*std::next(std_list.begin()));
+        unrolled_list.push_front(*std::next(unrolled_list.begin()));
+    }
+    ASSERT_THAT(unrolled_list, ::testing::ElementsAreArray(std_list));
+}
+
 TEST(UnrolledLinkedList, insertAndPushMixed) {
     std::list<int> std_list;
     unrolled_list<int> unrolled_list;
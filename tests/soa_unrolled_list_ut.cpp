@@ -0,0 +1,180 @@
+#include <soa_unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <list>
+#include <stdexcept>
+#include <tuple>
+
+// id, price, qty, timestamp
+using Order = std::tuple<int, double, int, int64_t>;
+
+Order MakeOrder(int i) {
+    return Order{i, i * 0.5, i % 7, int64_t(i) * 1000};
+}
+
+/*
+    Смешанные push_back / push_front / insert / erase на soa_unrolled_list и std::list.
+    Ожидается, что порядок элементов совпадёт, а каждое поле окажется в своей колонке.
+*/
+
+TEST(SoaUnrolledList, mixedOperations) {
+    std::list<Order> std_list;
+    soa_unrolled_list<Order, 8> soa_list;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3 == 0) {
+            std_list.push_front(MakeOrder(i));
+            soa_list.push_front(MakeOrder(i));
+        } else if (i % 3 == 1) {
+            std_list.push_back(MakeOrder(i));
+            soa_list.push_back(MakeOrder(i));
+        } else {
+            auto std_it = std_list.begin();
+            auto soa_it = soa_list.begin();
+            std::advance(std_it, std_list.size() / 2);
+            std::advance(soa_it, std_list.size() / 2);
+            std_list.insert(std_it, MakeOrder(i));
+            soa_list.insert(soa_it, MakeOrder(i));
+        }
+    }
+    for (int i = 0; i < 100; ++i) {
+        auto std_it = std_list.begin();
+        auto soa_it = soa_list.begin();
+        std::advance(std_it, i * 3);
+        std::advance(soa_it, i * 3);
+        std_list.erase(std_it);
+        soa_list.erase(soa_it);
+    }
+    std_list.pop_back();
+    soa_list.pop_back();
+    std_list.pop_front();
+    soa_list.pop_front();
+
+    ASSERT_EQ(soa_list.size(), std_list.size());
+    auto std_it = std_list.begin();
+    for (Order value : soa_list) {
+        ASSERT_EQ(value, *std_it);
+        ++std_it;
+    }
+}
+
+/*
+    column<I>() отдаёт по одному std::span на ноду, суммарно покрывающих все элементы.
+*/
+
+TEST(SoaUnrolledList, columnScan) {
+    soa_unrolled_list<Order, 16> soa_list;
+    int64_t expected_qty = 0;
+    double expected_price = 0;
+    for (int i = 0; i < 500; ++i) {
+        soa_list.push_back(MakeOrder(i));
+        expected_qty += i % 7;
+        expected_price += i * 0.5;
+    }
+
+    int64_t qty = 0;
+    size_t elements = 0;
+    for (std::span<int> segment : soa_list.column<2>()) {
+        ASSERT_LE(segment.size(), 16);
+        for (int value : segment) {
+            qty += value;
+        }
+        elements += segment.size();
+    }
+    double price = 0;
+    const auto& const_list = soa_list;
+    for (std::span<const double> segment : const_list.column<1>()) {
+        for (double value : segment) {
+            price += value;
+        }
+    }
+
+    ASSERT_EQ(elements, 500);
+    ASSERT_EQ(qty, expected_qty);
+    ASSERT_DOUBLE_EQ(price, expected_price);
+}
+
+/*
+    Прокси-ссылка позволяет читать и писать как весь элемент, так и отдельное поле.
+*/
+
+TEST(SoaUnrolledList, proxyReference) {
+    soa_unrolled_list<Order, 4> soa_list;
+    for (int i = 0; i < 10; ++i) {
+        soa_list.push_back(MakeOrder(i));
+    }
+    auto it = soa_list.begin();
+    std::advance(it, 5);
+    *it = MakeOrder(100);
+    ++it;
+    (*it).get<1>() = 42.0;
+
+    ASSERT_EQ(Order(*std::next(soa_list.begin(), 5)), MakeOrder(100));
+    ASSERT_EQ(std::get<1>(Order(*std::next(soa_list.begin(), 6))), 42.0);
+    ASSERT_EQ(soa_list.front().get<0>(), 0);
+    ASSERT_EQ(soa_list.back().get<3>(), 9000);
+
+    soa_list.clear();
+    ASSERT_TRUE(soa_list.empty());
+    soa_list.push_front(MakeOrder(1));
+    ASSERT_EQ(Order(soa_list.front()), MakeOrder(1));
+}
+
+/*
+    Вставка в полную ноду из одного или двух элементов: при разбиении хотя бы
+    один элемент уходит в новую ноду, и запись не выходит за колонки.
+*/
+
+TEST(SoaUnrolledList, insertIntoSmallNodes) {
+    soa_unrolled_list<std::tuple<int, int>, 2> pairs;
+    pairs.push_back({1, 1});
+    pairs.push_back({2, 2});
+    pairs.insert(pairs.cbegin(), {0, 0});
+    pairs.insert(std::next(pairs.cbegin(), 2), {5, 5});
+    std::list<std::tuple<int, int>> expected = {{0, 0}, {1, 1}, {5, 5}, {2, 2}};
+    auto same = [](auto lhs, const auto& rhs) { return std::tuple<int, int>(lhs) == rhs; };
+    ASSERT_TRUE(std::equal(pairs.begin(), pairs.end(), expected.begin(), expected.end(), same));
+
+    soa_unrolled_list<std::tuple<int>, 1> single;
+    single.push_back({1});
+    single.insert(single.cbegin(), {0});
+    single.insert(single.cend(), {2});
+    ASSERT_EQ(single.size(), 3);
+    ASSERT_EQ(std::get<0>(std::tuple<int>(*std::next(single.begin(), 1))), 1);
+}
+
+/*
+    Если копирование одного из полей бросает исключение, колонки остаются
+    согласованными: ни одно поле не сдвинуто и список не изменился.
+*/
+
+struct ThrowingField {
+    ThrowingField(int value) : value(value) {}
+    ThrowingField(const ThrowingField& other) : value(other.value) {
+        if (value < 0) {
+            throw std::runtime_error("copy");
+        }
+    }
+    ThrowingField(ThrowingField&&) noexcept = default;
+    ThrowingField& operator=(const ThrowingField&) = default;
+    ThrowingField& operator=(ThrowingField&&) noexcept = default;
+
+    int value;
+};
+
+TEST(SoaUnrolledList, throwingMemberCopyKeepsColumnsInStep) {
+    soa_unrolled_list<std::tuple<int, ThrowingField>, 8> soa_list;
+    for (int i = 0; i < 4; ++i) {
+        soa_list.push_back({i, ThrowingField(i)});
+    }
+    ASSERT_THROW(soa_list.insert(std::next(soa_list.cbegin(), 1), {10, ThrowingField(-1)}),
+                 std::runtime_error);
+    ASSERT_EQ(soa_list.size(), 4);
+    int i = 0;
+    for (auto it = soa_list.begin(); it != soa_list.end(); ++it, ++i) {
+        ASSERT_EQ((*it).get<0>(), i);
+        ASSERT_EQ((*it).get<1>().value, i);
+    }
+}
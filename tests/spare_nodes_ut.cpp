@@ -0,0 +1,152 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+
+struct SpareCounters {
+    static inline int Allocated = 0;
+    static inline int Deallocated = 0;
+};
+
+template<typename T>
+class SpareAllocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using size_type = size_t;
+    using is_always_equal = std::true_type;
+
+    SpareAllocator() = default;
+
+    template<typename U>
+    SpareAllocator(const SpareAllocator<U>& other) {
+    }
+
+    pointer allocate(size_type sz) {
+        ++SpareCounters::Allocated;
+        return reinterpret_cast<pointer>(new char[sz * sizeof(value_type)]);
+    }
+
+    void deallocate(pointer p, std::size_t n) {
+        ++SpareCounters::Deallocated;
+        delete[] reinterpret_cast<char*>(p);
+    }
+
+    bool operator==(const SpareAllocator& other) const {
+        return true;
+    }
+};
+
+class SpareNodesTest : public testing::Test {
+public:
+    void SetUp() override {
+        SpareCounters::Allocated = 0;
+        SpareCounters::Deallocated = 0;
+    }
+};
+
+/*
+    Очередь: чередуются пачки push_back и pop_front. После прогрева
+    ноды освобождаются с головы и переиспользуются в хвосте без аллокаций,
+    а все ноды, кроме крайних, заполнены полностью.
+*/
+
+TEST_F(SpareNodesTest, steadyQueueDoesNotAllocate) {
+    unrolled_list<int, 8, SpareAllocator<int>> queue;
+    queue.set_spare_nodes(3);
+    std::deque<int> model;
+    int next = 0;
+    for (int i = 0; i < 100; ++i) {
+        queue.push_back(next);
+        model.push_back(next++);
+    }
+    int warm = 0;
+
+    for (int round = 0; round < 1000; ++round) {
+        if (round == 1) {
+            warm = SpareCounters::Allocated;
+        }
+        for (int i = 0; i < 13; ++i) {
+            queue.push_back(next);
+            model.push_back(next++);
+        }
+        for (int i = 0; i < 13; ++i) {
+            ASSERT_EQ(queue.front(), model.front());
+            queue.pop_front();
+            model.pop_front();
+        }
+    }
+
+    ASSERT_EQ(SpareCounters::Allocated, warm);
+    ASSERT_THAT(queue, ::testing::ElementsAreArray(model));
+    ASSERT_LE(queue.max_size(), queue.size() + 2 * 8);
+}
+
+/*
+    Лимит кэша: reserve_nodes заранее выделяет ноды, set_spare_nodes(0)
+    возвращает их аллокатору, а при разрушении списка ничего не теряется.
+*/
+
+TEST_F(SpareNodesTest, retentionIsConfigurable) {
+    {
+        unrolled_list<int, 4, SpareAllocator<int>> list;
+        list.reserve_nodes(5);
+        ASSERT_EQ(list.spare_nodes(), 5);
+        int reserved = SpareCounters::Allocated;
+        for (int i = 0; i < 24; ++i) {
+            list.push_back(i);
+        }
+        ASSERT_EQ(SpareCounters::Allocated, reserved);
+        ASSERT_EQ(list.spare_nodes(), 0);
+
+        for (int i = 0; i < 24; ++i) {
+            list.pop_back();
+        }
+        ASSERT_EQ(list.spare_nodes(), 5);
+        list.set_spare_nodes(0);
+        ASSERT_EQ(list.spare_nodes(), 0);
+        ASSERT_EQ(SpareCounters::Deallocated, 5);
+    }
+    ASSERT_EQ(SpareCounters::Allocated, SpareCounters::Deallocated);
+}
+
+/*
+    clear() освобождает всю цепочку и сбрасывает счётчики, clear(n) оставляет
+    ноды для следующего заполнения, trim отдаёт лишние аллокатору.
+*/
+
+TEST_F(SpareNodesTest, clearRetainsNodes) {
+    {
+        unrolled_list<int, 8, SpareAllocator<int>> list;
+        for (int i = 0; i < 800; ++i) {
+            list.push_back(i);
+        }
+        list.clear();
+        ASSERT_TRUE(list.empty());
+        ASSERT_EQ(list.max_size(), 8);
+        ASSERT_EQ(list.spare_nodes(), 2);
+        ASSERT_EQ(SpareCounters::Allocated - SpareCounters::Deallocated, 3);
+
+        for (int tick = 0; tick < 100; ++tick) {
+            int allocated = SpareCounters::Allocated;
+            for (int i = 0; i < 800; ++i) {
+                list.push_back(tick + i);
+            }
+            if (tick > 0) {
+                ASSERT_EQ(SpareCounters::Allocated, allocated);
+            }
+            list.clear(100);
+            ASSERT_EQ(list.size(), 0);
+            ASSERT_EQ(list.begin(), list.end());
+        }
+        ASSERT_EQ(list.spare_nodes(), 99);
+
+        list.trim(10);
+        ASSERT_EQ(list.spare_nodes(), 10);
+        list.push_back(1);
+        ASSERT_THAT(list, ::testing::ElementsAre(1));
+    }
+    ASSERT_EQ(SpareCounters::Allocated, SpareCounters::Deallocated);
+}
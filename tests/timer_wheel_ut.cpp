@@ -0,0 +1,105 @@
+#include <timer_wheel.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+    Случайные push и pop_expired сравниваются с std::multimap: pop_expired
+    отдаёт ровно те таймеры, чей срок не позже now, по неубыванию срока, а
+    остальные остаются в колесе. Сроки разбросаны от ближайших тиков до
+    далёких, чтобы задействовать верхние уровни и пропуск пустых участков.
+*/
+
+TEST(TimerWheelTest, expiresLikeSortedModel) {
+    timer_wheel<int, 8> wheel(1000);
+    std::multimap<uint64_t, int> model;
+    std::mt19937_64 gen(49);
+    uint64_t now = 1000;
+    int next_value = 0;
+    for (int round = 0; round < 2000; ++round) {
+        for (int i = gen() % 6; i > 0; --i) {
+            uint64_t spread = uint64_t(1) << (gen() % 40);
+            uint64_t deadline = now + gen() % spread;
+            wheel.push(deadline, next_value);
+            model.emplace(deadline, next_value);
+            ++next_value;
+        }
+        now += gen() % 3 == 0 ? gen() % (uint64_t(1) << (gen() % 36)) : gen() % 100;
+
+        std::vector<std::pair<uint64_t, int>> expired;
+        size_t handed = wheel.pop_expired(now, [&](std::span<timer_entry<int>> chunk) {
+            for (timer_entry<int>& item : chunk) {
+                expired.emplace_back(item.deadline, item.value);
+            }
+        });
+        ASSERT_EQ(handed, expired.size());
+        std::vector<std::pair<uint64_t, int>> expected(model.begin(), model.upper_bound(now));
+        model.erase(model.begin(), model.upper_bound(now));
+        ASSERT_TRUE(std::is_sorted(expired.begin(), expired.end(),
+                                   [](auto& lhs, auto& rhs) { return lhs.first < rhs.first; }));
+        std::sort(expired.begin(), expired.end());
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(expired, expected);
+        ASSERT_EQ(wheel.size(), model.size());
+        ASSERT_EQ(wheel.current(), now + 1);
+    }
+}
+
+/*
+    Просроченный таймер срабатывает при следующем вызове; таймер, добавленный
+    из обработчика со сроком не позже now, отдаётся тем же вызовом. Все
+    таймеры одного тика приходят целыми нодами.
+*/
+
+TEST(TimerWheelTest, pastDeadlinesAndPushFromVisit) {
+    timer_wheel<std::string, 4> wheel(100);
+    wheel.push(5, std::string(40, 'a'));
+    for (int i = 0; i < 10; ++i) {
+        wheel.push(130, std::string(40, 'b'));
+    }
+    std::vector<size_t> chunks;
+    std::vector<std::string> seen;
+    size_t handed = wheel.pop_expired(130, [&](std::span<timer_entry<std::string>> chunk) {
+        chunks.push_back(chunk.size());
+        for (timer_entry<std::string>& item : chunk) {
+            seen.push_back(std::move(item.value));
+            if (seen.size() == 1) {
+                wheel.push(120, std::string(40, 'c'));
+            }
+        }
+    });
+    ASSERT_EQ(handed, 12);
+    ASSERT_EQ(seen.front(), std::string(40, 'a'));
+    ASSERT_EQ(seen.back(), std::string(40, 'b'));
+    ASSERT_EQ(std::count(seen.begin(), seen.end(), std::string(40, 'c')), 1);
+    ASSERT_THAT(chunks, ::testing::ElementsAre(1, 1, 4, 4, 2));
+    ASSERT_TRUE(wheel.empty());
+}
+
+/*
+    Ноды освободившихся корзин переиспользуются другими корзинами, пока
+    их число не превышает лимит запасных нод.
+*/
+
+TEST(TimerWheelTest, nodesAreRecycled) {
+    timer_wheel<int, 4> wheel;
+    wheel.set_spare_nodes(3);
+    for (int i = 0; i < 12; ++i) {
+        wheel.push(1, i);
+    }
+    wheel.pop_expired(1, [](std::span<timer_entry<int>>) {});
+    ASSERT_EQ(wheel.spare_nodes(), 3);
+    for (int i = 0; i < 8; ++i) {
+        wheel.push(70, i);
+    }
+    ASSERT_EQ(wheel.spare_nodes(), 1);
+    ASSERT_EQ(wheel.pop_expired(69, [](std::span<timer_entry<int>>) {}), 0);
+    ASSERT_EQ(wheel.pop_expired(70, [](std::span<timer_entry<int>>) {}), 8);
+    ASSERT_EQ(wheel.spare_nodes(), 3);
+}
@@ -0,0 +1,97 @@
+#include <unrolled_list.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+typedef unrolled_list<int, 8, std::allocator<int>, latency_histograms> traced_list;
+
+/*
+    Политика по умолчанию ничего не добавляет: её scope пустой и тривиально
+    разрушаемый, а список без неё и с ней имеет один и тот же размер.
+*/
+
+TEST(TraceTest, defaultPolicyIsEmpty) {
+    static_assert(std::is_empty_v<no_instrumentation::scope>);
+    static_assert(std::is_trivially_destructible_v<no_instrumentation::scope>);
+    static_assert(sizeof(unrolled_list<int, 8>) == sizeof(traced_list));
+}
+
+/*
+    Каждая операция попадает ровно в одну гистограмму: 100 push_back на ноды
+    по 8 дают 13 выделений нод, вставка в полную ноду — одно разбиение.
+*/
+
+TEST(TraceTest, countsEveryOperation) {
+    latency_histograms::reset();
+    {
+        traced_list list;
+        for (int i = 0; i < 100; ++i) {
+            list.push_back(i);
+        }
+        list.insert(list.cbegin(), -1);
+        list.erase(list.cbegin());
+        for (int i = 0; i < 10; ++i) {
+            list.pop_front();
+        }
+    }
+    latency_snapshot snapshot = latency_histograms::snapshot();
+    ASSERT_EQ(snapshot.total(list_op::push), 100);
+    ASSERT_EQ(snapshot.total(list_op::insert), 1);
+    ASSERT_EQ(snapshot.total(list_op::split), 1);
+    ASSERT_EQ(snapshot.total(list_op::erase), 1);
+    ASSERT_EQ(snapshot.total(list_op::pop), 10);
+    ASSERT_EQ(snapshot.total(list_op::node_alloc), 13);
+    ASSERT_LE(snapshot.quantile(list_op::push, 0.5), snapshot.quantile(list_op::push, 1.0));
+}
+
+/*
+    Потоки пишут в свои блоки, снимок суммирует все блоки, в том числе
+    блоки уже завершившихся потоков.
+*/
+
+TEST(TraceTest, snapshotSumsThreads) {
+    latency_histograms::reset();
+    std::thread workers[4];
+    for (std::thread& worker : workers) {
+        worker = std::thread([] {
+            traced_list list;
+            for (int i = 0; i < 1000; ++i) {
+                list.push_back(i);
+                list.pop_back();
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    latency_snapshot snapshot = latency_histograms::snapshot();
+    ASSERT_EQ(snapshot.total(list_op::push), 4000);
+    ASSERT_EQ(snapshot.total(list_op::pop), 4000);
+}
+
+/*
+    Текстовый снимок содержит строку на каждую встреченную операцию, JSON —
+    все операции с непустыми корзинами.
+*/
+
+TEST(TraceTest, exportsTextAndJson) {
+    latency_histograms::reset();
+    traced_list list;
+    list.push_back(1);
+    latency_snapshot snapshot = latency_histograms::snapshot();
+
+    std::ostringstream text;
+    snapshot.write_text(text);
+    ASSERT_THAT(text.str(), ::testing::StartsWith("push count=1 "));
+    ASSERT_THAT(text.str(), ::testing::Not(::testing::HasSubstr("erase")));
+
+    std::ostringstream json;
+    snapshot.write_json(json);
+    ASSERT_THAT(json.str(), ::testing::StartsWith("{\"unit\":\""));
+    ASSERT_THAT(json.str(), ::testing::HasSubstr("\"push\":{\"count\":1,\"buckets\":[["));
+    ASSERT_THAT(json.str(), ::testing::HasSubstr("\"erase\":{\"count\":0,\"buckets\":[]}"));
+}
@@ -0,0 +1,105 @@
+#include <unrolled_list.h>
+#include <unrolled_list_views.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
+
+static_assert(std::ranges::bidirectional_range<unrolled_list<int>>);
+static_assert(std::ranges::bidirectional_range<const unrolled_list<int>>);
+static_assert(std::ranges::sized_range<unrolled_list<int>>);
+static_assert(std::ranges::common_range<unrolled_list<int>>);
+static_assert(std::bidirectional_iterator<unrolled_list<int>::reverse_iterator>);
+static_assert(std::sentinel_for<std::default_sentinel_t, unrolled_list<int>::iterator>);
+
+/*
+    Список работает со стандартными алгоритмами и адаптерами ranges, в том
+    числе с обходом до std::default_sentinel.
+*/
+
+TEST(ViewsTest, standardRanges) {
+    unrolled_list<int, 4> list;
+    for (int i = 0; i < 30; ++i) {
+        list.push_back(i);
+    }
+    auto odd = list | std::views::filter([](int x) { return x % 2; }) | std::views::reverse;
+    std::vector<int> expected;
+    for (int i = 29; i > 0; i -= 2) {
+        expected.push_back(i);
+    }
+    ASSERT_TRUE(std::ranges::equal(odd, expected));
+    ASSERT_EQ(std::ranges::distance(list), 30);
+    ASSERT_EQ(*std::ranges::max_element(list), 29);
+
+    int sum = 0;
+    for (auto it = list.begin(); it != std::default_sentinel; ++it) {
+        sum += *it;
+    }
+    ASSERT_EQ(sum, 435);
+    unrolled_list<int, 4> empty;
+    ASSERT_TRUE(empty.begin() == std::default_sentinel);
+    ASSERT_TRUE(empty.rbegin() == std::default_sentinel);
+}
+
+/*
+    nodes() и segments() покрывают все элементы ровно один раз, и каждый
+    сегмент — непрерывный кусок ноды.
+*/
+
+TEST(ViewsTest, nodesAndSegments) {
+    unrolled_list<int, 8> list;
+    for (int i = 0; i < 50; ++i) {
+        list.push_back(i);
+        list.push_front(-i);
+    }
+    size_t elements = 0;
+    for (const auto& temp : list.nodes()) {
+        elements += temp.end;
+    }
+    ASSERT_EQ(elements, list.size());
+
+    std::vector<int> joined;
+    for (std::span<int> segment : list.segments()) {
+        ASSERT_LE(segment.size(), 8);
+        joined.insert(joined.end(), segment.begin(), segment.end());
+    }
+    ASSERT_THAT(list, ::testing::ElementsAreArray(joined));
+
+    for (std::span<int> segment : list.segments()) {
+        std::ranges::fill(segment, 1);
+    }
+    const auto& view = list;
+    int sum = 0;
+    for (std::span<const int> segment : view.segments()) {
+        sum = std::accumulate(segment.begin(), segment.end(), sum);
+    }
+    ASSERT_EQ(sum, 100);
+}
+
+/*
+    filter_into / transform_into собирают результат прямо в новый список,
+    заполняя ноды целиком, и цепочка стадий совпадает с ручным циклом.
+*/
+
+TEST(ViewsTest, pipelineMaterializesIntoList) {
+    unrolled_list<int, 16> list;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 1000; ++i) {
+        list.push_back(i);
+        if (i % 3 == 0) {
+            expected.push_back(std::to_string(i * 2));
+        }
+    }
+    auto out = list | filter_into([](int x) { return x % 3 == 0; })
+                    | transform_into([](int x) { return x * 2; })
+                    | transform_into([](int x) { return std::to_string(x); });
+    static_assert(std::is_same_v<decltype(out), unrolled_list<std::string, 16>>);
+    ASSERT_THAT(out, ::testing::ElementsAreArray(expected));
+    ASSERT_EQ(out.size(), expected.size());
+    ASSERT_EQ(out.max_size(), (expected.size() + 15) / 16 * 16);
+}